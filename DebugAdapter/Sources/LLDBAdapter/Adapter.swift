@@ -13,7 +13,10 @@ final class Adapter: DebugAdapterServerRequestHandler {
     
     private var isRunning = false
     private var debugger: Debugger?
-    private var eventsTask: Task<(), Never>?
+    private var eventPump: EventPump?
+    private var progressReporter: ProgressReporter?
+    private let scheduler = RequestScheduler()
+    private var signalSources: [DispatchSourceSignal] = []
     
     func resume() {
         guard !isRunning else {
@@ -21,8 +24,17 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
         isRunning = true
         
-        signal(SIGINT) { _ in Adapter.shared.shutdown() }
-        signal(SIGTERM) { _ in Adapter.shared.shutdown() }
+        // Shutting down stops the event pump and flushes the connection, which is not safe in a signal
+        // handler, so signals are delivered to the main queue instead.
+        for signalNumber in [SIGINT, SIGTERM] {
+            signal(signalNumber, SIG_IGN)
+            let source = DispatchSource.makeSignalSource(signal: signalNumber, queue: .main)
+            source.setEventHandler {
+                Adapter.shared.shutdown()
+            }
+            source.resume()
+            signalSources.append(source)
+        }
         
         var configuration = DebugAdapterConnection.Configuration()
         configuration.messageQueue = .main
@@ -30,6 +42,17 @@ final class Adapter: DebugAdapterServerRequestHandler {
             self?.shutdown(error: error)
         }
         configuration.requestHandler = self
+        configuration.responseMetricsHandler = { [responseStatistics] metrics in
+            responseStatistics.withLock { $0.record(metrics) }
+        }
+        
+        // Requests that end the session interrupt all work in flight, on every lane, rather than waiting for it.
+        scheduler.interruptHandler = { [weak self] in
+            self?.debugger?.requestInterrupt()
+        }
+        scheduler.cancelInterruptHandler = { [weak self] in
+            self?.debugger?.cancelInterruptRequest()
+        }
         
         connection.setConfiguration(configuration)
         connection.start()
@@ -43,20 +66,40 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
         isRunning = false
         
-        eventsTask?.cancel()
-        eventsTask = nil
+        eventPump?.stop()
+        eventPump = nil
         
         target = nil
         debugger = nil
         
         connection.stop()
+        connection.flush()
         
         exit(error != nil ? EXIT_FAILURE : EXIT_SUCCESS)
     }
     
     func handleRequest(_ request: DebugAdapterConnection.IncomingRequest) {
+        scheduler.schedule(request) { [weak self] request in
+            self?.performHandling(for: request)
+        }
+    }
+    
+    private func performHandling(for request: DebugAdapterConnection.IncomingRequest) {
         do {
             switch request.command {
+            case _ where isPostmortem && Self.postmortemUnsupportedCommands.contains(request.command):
+                throw AdapterError.postmortem
+                
+            case _ where Self.interruptibleCommands.contains(request.command):
+                try performInterruptibleHandling(for: request)
+                
+            case Self.statisticsCommand:
+                let (arguments, replyHandler) = try request.decodeForReply(StatisticsArguments.self, resultType: JSONValue.self)
+                replyHandler(.success(statistics(summaryOnly: arguments?.summaryOnly ?? false)))
+                
+            case MemorySearch.command:
+                let (arguments, replyHandler) = try request.decodeForReply(MemorySearch.Arguments.self, resultType: MemorySearch.Result.self)
+                searchMemory(arguments, replyHandler: replyHandler)
                 
             default:
                 try performDefaultHandling(for: request)
@@ -67,12 +110,106 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
     }
     
+    /// Requests that run or modify the debuggee, which are refused when it is a core file.
+    private static let postmortemUnsupportedCommands: Set<String> = [
+        DebugAdapter.ContinueRequest.command,
+        DebugAdapter.NextRequest.command,
+        DebugAdapter.StepInRequest.command,
+        DebugAdapter.StepOutRequest.command,
+        DebugAdapter.PauseRequest.command,
+        DebugAdapter.GotoRequest.command,
+        DebugAdapter.SetVariableRequest.command,
+        DebugAdapter.SetExpressionRequest.command,
+        DebugAdapter.WriteMemoryRequest.command,
+    ]
+    
+    // MARK: - Cancellation
+    
+    /// Requests whose LLDB work is interrupted when the client cancels them.
+    private static let interruptibleCommands: Set<String> = [
+        DebugAdapter.CompletionsRequest.command,
+        DebugAdapter.DisassembleRequest.command,
+        DebugAdapter.EvaluateRequest.command,
+        DebugAdapter.StackTraceRequest.command,
+        DebugAdapter.VariablesRequest.command,
+    ]
+    
+    /// Tracks whether a cancellation interrupted LLDB while its request was still being handled,
+    /// so that a cancellation arriving after handling finishes does not leave the debugger interrupted.
+    private final class InterruptScope: @unchecked Sendable {
+        private let lock = NSLock()
+        private let debugger: Debugger
+        private var isActive = true
+        private var isInterrupted = false
+        
+        init(debugger: Debugger) {
+            self.debugger = debugger
+        }
+        
+        /// Interrupts LLDB if the request is still being handled.
+        /// Invoked by the scheduler only once no other request's work would be interrupted as well.
+        func interrupt() {
+            lock.lock()
+            defer { lock.unlock() }
+            if isActive && !isInterrupted {
+                isInterrupted = true
+                debugger.requestInterrupt()
+            }
+        }
+        
+        func end() {
+            lock.lock()
+            defer { lock.unlock() }
+            isActive = false
+            if isInterrupted {
+                debugger.cancelInterruptRequest()
+            }
+        }
+    }
+    
+    private func performInterruptibleHandling(for request: DebugAdapterConnection.IncomingRequest) throws {
+        let token = request.cancellationToken
+        if token.isCancelled {
+            // Cancelled while waiting to be handled.
+            throw DebugAdapterConnection.ResponseError.cancelled
+        }
+        
+        guard let debugger else {
+            try performDefaultHandling(for: request)
+            return
+        }
+        
+        let scope = InterruptScope(debugger: debugger)
+        token.onCancel { [scheduler] in
+            scheduler.interruptWhenRunningAlone {
+                scope.interrupt()
+            }
+        }
+        
+        defer {
+            scope.end()
+        }
+        
+        try performDefaultHandling(for: request)
+    }
+    
+    /// Throws a cancellation error if the request being handled has been cancelled.
+    /// Invoked between units of work in loops that LLDB cannot interrupt on its own.
+    private func checkCancellation() throws {
+        if RequestScheduler.currentRequest?.cancellationToken.isCancelled ?? false {
+            throw DebugAdapterConnection.ResponseError.cancelled
+        }
+    }
+    
     private struct ClientOptions: Sendable {
         var clientID: String?
         var clientName: String?
         var adapterID: String?
         var linesStartAt1 = true
         var columnsStartAt1 = true
+        var supportsProgressReporting = false
+        var supportsMemoryEvent = false
+        var supportsInvalidatedEvent = false
     }
     private var clientOptions = ClientOptions()
     
@@ -134,7 +271,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
         
         // Debugger
-        self.debugger = Debugger()
+        let debugger = Debugger()
+        self.debugger = debugger
         
         // Client options
         var options = ClientOptions()
@@ -143,20 +281,38 @@ final class Adapter: DebugAdapterServerRequestHandler {
         options.adapterID = request.adapterID
         options.linesStartAt1 = request.linesStartAt1 ?? true
         options.columnsStartAt1 = request.columnsStartAt1 ?? true
+        options.supportsProgressReporting = request.supportsProgressReporting ?? false
+        options.supportsMemoryEvent = request.supportsMemoryEvent ?? false
+        options.supportsInvalidatedEvent = request.supportsInvalidatedEvent ?? false
         clientOptions = options
         
         // Event listener
-        eventsTask = Task {
-            await listenForEvents()
+        eventPump?.stop()
+        let eventPump = EventPump(debugger: debugger, queue: .main) { [weak self] event, receivedAt in
+            self?.handleEvent(event, receivedAt: receivedAt)
+        }
+        eventPump.start()
+        self.eventPump = eventPump
+        
+        // Progress
+        var progressOptions = ProgressReporter.Options()
+        progressOptions.showsProgress = options.supportsProgressReporting
+        progressReporter = ProgressReporter(options: progressOptions, connection: connection, queue: .main) { [weak self] summary in
+            self?.output(summary, category: .telemetry)
         }
+        debugger.startListeningForProgress()
         
         // Capabilities
         var capabilities = DebugAdapter.Capabilities()
         
         capabilities.supportsConfigurationDoneRequest = true
         
+        capabilities.supportsBreakpointLocationsRequest = true
+        capabilities.supportsModulesRequest = true
         capabilities.supportsFunctionBreakpoints = true
         capabilities.supportsConditionalBreakpoints = true
+        capabilities.supportsHitConditionalBreakpoints = true
+        capabilities.supportsLogPoints = true
         capabilities.supportsDataBreakpoints = true
         capabilities.supportsDataBreakpointBytes = true
         capabilities.supportsInstructionBreakpoints = true
@@ -165,8 +321,10 @@ final class Adapter: DebugAdapterServerRequestHandler {
         capabilities.supportsExceptionFilterOptions = true
         
         capabilities.supportsSteppingGranularity = true
+        capabilities.supportsGotoTargetsRequest = true
         capabilities.supportsRestartRequest = true
         capabilities.supportsExceptionInfoRequest = true
+        capabilities.supportsDelayedStackTraceLoading = true
         capabilities.supportTerminateDebuggee = true
         capabilities.supportsTerminateRequest = true
         capabilities.supportsReadMemoryRequest = true
@@ -179,25 +337,39 @@ final class Adapter: DebugAdapterServerRequestHandler {
         capabilities.supportsSetVariable = true
         capabilities.supportsANSIStyling = true
         
+        capabilities.supportsCancelRequest = true
+        
         replyHandler(.success(capabilities))
     }
     
-    private func listenForEvents() async {
-        guard let debugger else {
-            return
+    /// Time from LLDB broadcasting an event to the adapter finishing handling it.
+    private var eventLatency = LatencyHistogram()
+    
+    /// Time from LLDB broadcasting a stop to the adapter sending its `stopped` event.
+    private var stopLatency = LatencyHistogram()
+    
+    private func handleEvent(_ event: Event, receivedAt: ContinuousClock.Instant) {
+        switch event {
+        case let .breakpoint(event):
+            handleBreakpointEvent(event)
+        case let .process(event):
+            handleProcessEvent(event)
+        case let .target(event):
+            handleTargetEvent(event)
+        case let .progress(event):
+            progressReporter?.handle(event, receivedAt: receivedAt)
+        default:
+            break
         }
         
-        for await event in debugger.events {
-            Task {
-                switch event {
-                case let .breakpoint(event):
-                    await handleBreakpointEvent(event)
-                case let .process(event):
-                    await handleProcessEvent(event)
-                default:
-                    break
-                }
-            }
+        let latency = receivedAt.duration(to: .now)
+        eventLatency.record(latency)
+        
+        if case let .process(event) = event,
+           event.eventType.contains(.stateChanged),
+           event.processState == .stopped,
+           !event.isRestarted {
+            stopLatency.record(latency)
         }
     }
     
@@ -206,17 +378,27 @@ final class Adapter: DebugAdapterServerRequestHandler {
     private enum DebugRequest {
         case launch(Target.LaunchOptions)
         case attach(Target.AttachOptions)
+        case core(path: String)
         
         var shouldTerminateDebuggee: Bool {
             switch self {
             case .launch:
                 return true
-            case .attach:
+            case .attach, .core:
                 return false
             }
         }
     }
     private var debugRequest: DebugRequest?
+    
+    /// Whether the debuggee is a core file, which can be inspected but not run or modified.
+    private var isPostmortem: Bool {
+        if case .core = debugRequest {
+            return true
+        }
+        return false
+    }
+    
     private var isLocal = false
     private var terminateDebuggee = false
     
@@ -270,6 +452,23 @@ final class Adapter: DebugAdapterServerRequestHandler {
         var host: String?
         var platform: String?
         var pathMappings: [PathMapping]?
+        
+        /// The path of a core file to inspect instead of launching `program`, which must be the binary that
+        /// produced it. Path mappings also locate the core's other modules on this machine.
+        var coreFile: String?
+        
+        /// Milliseconds to wait for more debuggee output before sending it. `0` sends output as soon as it is read.
+        var outputBatchInterval: Int?
+        /// The number of bytes of buffered debuggee output that is sent without waiting.
+        var outputBatchSize: Int?
+        /// The number of bytes of debuggee output per second sent before further output is elided. `0` disables the limit.
+        var outputRateLimit: Int?
+        
+        /// Whether to parse each module's symbols only when they are first needed, rather than as it loads.
+        /// Defaults to `false`, or to `true` for a core file.
+        var deferSymbolLoading: Bool?
+        /// Names or paths of modules, which may contain `*` wildcards, whose symbols are still loaded eagerly when loading is deferred.
+        var symbolLoadAllowList: [String]?
     }
     
     func launch(_ request: DebugAdapter.LaunchRequest<LaunchParameters>, replyHandler: @escaping (Result<(), Error>) -> Void) {
@@ -297,6 +496,18 @@ final class Adapter: DebugAdapterServerRequestHandler {
         var host: String?
         var platform: String?
         var pathMappings: [PathMapping]?
+        
+        /// Milliseconds to wait for more debuggee output before sending it. `0` sends output as soon as it is read.
+        var outputBatchInterval: Int?
+        /// The number of bytes of buffered debuggee output that is sent without waiting.
+        var outputBatchSize: Int?
+        /// The number of bytes of debuggee output per second sent before further output is elided. `0` disables the limit.
+        var outputRateLimit: Int?
+        
+        /// Whether to parse each module's symbols only when they are first needed, rather than as it loads. Defaults to `false`.
+        var deferSymbolLoading: Bool?
+        /// Names or paths of modules, which may contain `*` wildcards, whose symbols are still loaded eagerly when loading is deferred.
+        var symbolLoadAllowList: [String]?
     }
     
     func attach(_ request: DebugAdapter.AttachRequest<AttachParameters>, replyHandler: @escaping (Result<(), Error>) -> Void) {
@@ -328,8 +539,10 @@ final class Adapter: DebugAdapterServerRequestHandler {
             architecture = .x86_64
         }
         
+        try prepareSymbolLoading(debugger: debugger, isDeferred: parameters.deferSymbolLoading ?? (parameters.coreFile != nil), allowList: parameters.symbolLoadAllowList ?? [])
+        
         let target: Target
-        if let port = parameters.port {
+        if let port = parameters.port, parameters.coreFile == nil {
             // Server Port
             let host = parameters.host ?? "localhost"
             let platformName = parameters.platform ?? Self.defaultRemotePlatform
@@ -353,9 +566,16 @@ final class Adapter: DebugAdapterServerRequestHandler {
             isLocal = true
         }
         
-        debugRequest = .launch(options)
+        if let coreFile = parameters.coreFile {
+            debugRequest = .core(path: coreFile)
+        }
+        else {
+            debugRequest = .launch(options)
+        }
         terminateDebuggee = false
         
+        prepareOutput(batchInterval: parameters.outputBatchInterval, batchSize: parameters.outputBatchSize, rateLimit: parameters.outputRateLimit)
+        
         pathMappings = (parameters.pathMappings ?? []).map { mapping in
             var local = mapping.local
             if !local.hasSuffix("/") {
@@ -370,6 +590,13 @@ final class Adapter: DebugAdapterServerRequestHandler {
             return PathMapping(local: local, remote: remote)
         }
         
+        if isPostmortem {
+            // The core's modules are found when it loads, so they must be searched for under the mappings first.
+            for mapping in pathMappings {
+                try target.appendImageSearchPath(from: String(mapping.remote.dropLast()), to: String(mapping.local.dropLast()))
+            }
+        }
+        
         prepareForStart(target: target, replyHandler: replyHandler)
     }
     
@@ -380,6 +607,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
         
         var options: Target.AttachOptions
         
+        try prepareSymbolLoading(debugger: debugger, isDeferred: parameters.deferSymbolLoading ?? false, allowList: parameters.symbolLoadAllowList ?? [])
+        
         let target: Target
         if let port = parameters.port, let path = parameters.program {
             // Server Port
@@ -427,6 +656,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
         debugRequest = .attach(options)
         terminateDebuggee = false
         
+        prepareOutput(batchInterval: parameters.outputBatchInterval, batchSize: parameters.outputBatchSize, rateLimit: parameters.outputRateLimit)
+        
         pathMappings = (parameters.pathMappings ?? []).map { mapping in
             var local = mapping.local
             if !local.hasSuffix("/") {
@@ -448,8 +679,11 @@ final class Adapter: DebugAdapterServerRequestHandler {
         self.startReplyHandler = replyHandler
         self.target = target
         
-        // Listen for breakpoint change events from the target.
-        debugger?.startListening(to: target, events: [.breakpointChanged])
+        // Cached disassembly holds instruction lists that would keep the previous target's modules alive.
+        disassemblyCache.removeAll()
+        
+        // Listen for breakpoint change and module events from the target.
+        debugger?.startListening(to: target, events: [.breakpointChanged, .modulesLoaded, .modulesUnloaded, .symbolsLoaded])
         
         connection.send(DebugAdapter.InitializedEvent())
     }
@@ -482,6 +716,15 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 else {
                     sendProcessEvent(process, startMethod: .attach)
                 }
+                
+            case let .core(path):
+                output("Loading core file “\(path)”…")
+                
+                // LLDB maps the core file and reads only the pages that requests touch, so this is fast
+                // even for a large core. A core never changes state, so its stop is reported here.
+                let process = try target.loadCore(path: path)
+                sendProcessEvent(process, startMethod: .attach)
+                sendThreadStoppedEvent()
             }
             startReplyHandler?(.success(()))
         }
@@ -510,7 +753,7 @@ final class Adapter: DebugAdapterServerRequestHandler {
             }
             
             switch debugRequest {
-            case .launch:
+            case .launch, .core:
                 let (request, replyHandler) = try request.decodeForReplyAsLaunch()
                 if let arguments = request.arguments {
                     try prepareForLaunch(parameters: arguments, replyHandler: replyHandler)
@@ -540,7 +783,7 @@ final class Adapter: DebugAdapterServerRequestHandler {
     }
     
     func disconnect(_ request: DebugAdapter.DisconnectRequest, replyHandler: @escaping (Result<(), Error>) -> Void) {
-        if let process = target?.process {
+        if let process = target?.process, !isPostmortem {
             switch process.state {
             case .invalid,
                 .unloaded,
@@ -601,6 +844,26 @@ final class Adapter: DebugAdapterServerRequestHandler {
     private var dataBreakpoints: [Int: DebugAdapter.DataBreakpoint] = [:]
     private var exceptionBreakpoints: [Int: ExceptionFilter] = [:]
     
+    private var breakpointHitHandlers: [Int: BreakpointHitHandler] = [:]
+    
+    /// Handlers that were replaced or removed while the process was running. LLDB may still be running
+    /// their callbacks for a hit that began before, so they are kept alive until the process stops.
+    private var retiredBreakpointHitHandlers: [BreakpointHitHandler] = []
+    
+    
+    private var lineTableIndex = LineTableIndex()
+    
+    /// Identifies a source breakpoint within its file, for matching requested breakpoints to existing ones.
+    private struct SourceLocationKey: Hashable {
+        var line: Int
+        var column: Int?
+    }
+    
+    private struct DataBreakpointKey: Hashable {
+        var dataId: String
+        var accessType: DebugAdapter.DataBreakpoint.AccessType?
+    }
+    
     private func adapterBreakpoint(for breakpoint: SwiftLLDB.Breakpoint) -> DebugAdapter.Breakpoint {
         var result = DebugAdapter.Breakpoint(id: breakpoint.id)
         
@@ -624,13 +887,12 @@ final class Adapter: DebugAdapterServerRequestHandler {
         return result
     }
     
-    @MainActor
     private func handleBreakpointEvent(_ event: BreakpointEvent) {
         switch event.eventType {
         case .locationsAdded, .locationsResolved:
             let breakpoint = event.breakpoint
             if breakpoint.matchesName(Self.breakpointLabel) {
-                connection.send(DebugAdapter.BreakpointEvent(reason: .changed, breakpoint: adapterBreakpoint(for: breakpoint)))
+                scheduleBreakpointChange(forBreakpointID: breakpoint.id)
             }
             
         default:
@@ -638,6 +900,107 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
     }
     
+    // Loading a library with many pending breakpoints produces a burst of location events for each
+    // of them. Changes are collected until no more have arrived for `breakpointChangeInterval`, or
+    // `maximumBreakpointChangeDelay` has passed, and then one event is sent with each breakpoint's
+    // final state.
+    
+    private static let breakpointChangeInterval: Duration = .milliseconds(50)
+    private static let maximumBreakpointChangeDelay: Duration = .milliseconds(500)
+    
+    private var changedBreakpointIDs: Set<Int> = []
+    private var firstBreakpointChange: ContinuousClock.Instant?
+    private var lastBreakpointChange: ContinuousClock.Instant?
+    
+    /// The state last reported for each breakpoint, so that changes LLDB reports but the client would not see are not sent.
+    private var reportedBreakpoints: [Int: DebugAdapter.Breakpoint] = [:]
+    
+    private func scheduleBreakpointChange(forBreakpointID id: Int) {
+        let now = ContinuousClock.now
+        changedBreakpointIDs.insert(id)
+        lastBreakpointChange = now
+        
+        if firstBreakpointChange == nil {
+            firstBreakpointChange = now
+            scheduleBreakpointChangeFlush(after: Self.breakpointChangeInterval)
+        }
+    }
+    
+    private func scheduleBreakpointChangeFlush(after delay: Duration) {
+        let (seconds, attoseconds) = delay.components
+        let interval = Double(seconds) + Double(attoseconds) / 1e18
+        
+        DispatchQueue.main.asyncAfter(deadline: .now() + interval) { [weak self] in
+            guard let self, let firstBreakpointChange = self.firstBreakpointChange, let lastBreakpointChange = self.lastBreakpointChange else {
+                return
+            }
+            
+            let now = ContinuousClock.now
+            let quietDeadline = lastBreakpointChange + Self.breakpointChangeInterval
+            let finalDeadline = firstBreakpointChange + Self.maximumBreakpointChangeDelay
+            if now < quietDeadline && now < finalDeadline {
+                self.scheduleBreakpointChangeFlush(after: now.duration(to: min(quietDeadline, finalDeadline)))
+            }
+            else {
+                self.flushBreakpointChanges()
+            }
+        }
+    }
+    
+    /// Sends a `changed` event for each breakpoint whose locations changed since the last flush.
+    private func flushBreakpointChanges() {
+        let ids = changedBreakpointIDs
+        changedBreakpointIDs.removeAll()
+        firstBreakpointChange = nil
+        lastBreakpointChange = nil
+        
+        guard let target else {
+            return
+        }
+        
+        for id in ids.sorted() {
+            // Breakpoints removed since their locations changed are not reported.
+            guard let breakpoint = target.findBreakpoint(id: id) else {
+                continue
+            }
+            
+            let result = adapterBreakpoint(for: breakpoint)
+            if reportedBreakpoints[id] != result {
+                reportedBreakpoints[id] = result
+                connection.send(DebugAdapter.BreakpointEvent(reason: .changed, breakpoint: result))
+            }
+        }
+    }
+    
+    func breakpointLocations(_ request: DebugAdapter.BreakpointLocationsRequest, replyHandler: @escaping (Result<DebugAdapter.BreakpointLocationsRequest.Result, Error>) -> Void) {
+        guard let target else {
+            replyHandler(.failure(AdapterError.notDebugging))
+            return
+        }
+        
+        // Sources without a path have no line table.
+        guard let path = request.source.path else {
+            replyHandler(.success(.init(breakpoints: [])))
+            return
+        }
+        
+        let lineOffset = clientOptions.linesStartAt1 ? 0 : 1
+        let columnOffset = clientOptions.columnsStartAt1 ? 0 : 1
+        
+        let start = LineTableIndex.Position(line: request.line + lineOffset, column: request.column.map { $0 + columnOffset })
+        let end = LineTableIndex.Position(line: (request.endLine ?? request.line) + lineOffset, column: request.endColumn.map { $0 + columnOffset } ?? .max)
+        
+        let positions = lineTableIndex.positions(inFileAt: remotePath(forLocalPath: path), from: start, through: end, in: target)
+        
+        let locations = positions.map { position in
+            var location = DebugAdapter.BreakpointLocation(line: position.line - lineOffset)
+            location.column = position.column.map { $0 - columnOffset }
+            return location
+        }
+        
+        replyHandler(.success(.init(breakpoints: locations)))
+    }
+    
     func setBreakpoints(_ request: DebugAdapter.SetBreakpointsRequest, replyHandler: @escaping (Result<DebugAdapter.SetBreakpointsRequest.Result, Error>) -> Void) {
         guard let target else {
             replyHandler(.failure(AdapterError.notDebugging))
@@ -658,49 +1021,64 @@ final class Adapter: DebugAdapterServerRequestHandler {
             return
         }
         
-        var results: [DebugAdapter.Breakpoint] = []
-        var newBreakpoints: [Int: DebugAdapter.SourceBreakpoint] = [:]
-        var previousBreakpoints = sourceBreakpoints[ref] ?? [:]
+        let sourceBreakpointsRequested = request.breakpoints ?? []
         
-        for sourceBreakpoint in request.breakpoints ?? [] {
-            let line = sourceBreakpoint.line
-            let column = sourceBreakpoint.column
-            
-            do {
-                let breakpoint: Breakpoint
-                if let match = previousBreakpoints.first(where: { $0.value.line == line && $0.value.column == column }),
-                let bp = target.findBreakpoint(id: match.key) {
-                    breakpoint = bp
-                    previousBreakpoints[match.key] = nil
-                }
-                else {
-                    switch ref {
-                    case .path(let path):
-                        let resolvedPath = remotePath(forLocalPath: path)
-                        breakpoint = target.createBreakpoint(path: resolvedPath, line: line, column: column)
-                    case .ref(let reference):
-                        throw AdapterError.invalidParameter("Invalid source reference: “\(reference)”.")
-                    }
-                    
-                    // See comments for `Self.breakpointLabel` for details of why we add a label to our breakpoints.
-                    try? breakpoint.addName(Self.breakpointLabel)
-                }
-                
-                breakpoint.condition = sourceBreakpoint.condition
+        // Match requested breakpoints to existing ones by location, then create the rest.
+        let previousBreakpoints = sourceBreakpoints[ref] ?? [:]
+        var previousIDs: [SourceLocationKey: [Int]] = [:]
+        for (id, sourceBreakpoint) in previousBreakpoints {
+            previousIDs[SourceLocationKey(line: sourceBreakpoint.line, column: sourceBreakpoint.column), default: []].append(id)
+        }
+        
+        var breakpoints = [Breakpoint?](repeating: nil, count: sourceBreakpointsRequested.count)
+        var createdIndices: [Int] = []
+        for (index, sourceBreakpoint) in sourceBreakpointsRequested.enumerated() {
+            let key = SourceLocationKey(line: sourceBreakpoint.line, column: sourceBreakpoint.column)
+            if let id = previousIDs[key]?.popLast(), let bp = target.findBreakpoint(id: id) {
+                breakpoints[index] = bp
+            }
+            else {
+                createdIndices.append(index)
+            }
+        }
+        
+        if case .path(let path) = ref {
+            let resolvedPath = remotePath(forLocalPath: path)
+            for index in createdIndices {
+                let sourceBreakpoint = sourceBreakpointsRequested[index]
+                let breakpoint = target.createBreakpoint(path: resolvedPath, line: sourceBreakpoint.line, column: sourceBreakpoint.column)
                 
-                let result = adapterBreakpoint(for: breakpoint)
+                // See comments for `Self.breakpointLabel` for details of why we add a label to our breakpoints.
+                try? breakpoint.addName(Self.breakpointLabel)
                 
-                newBreakpoints[breakpoint.id] = sourceBreakpoint
-                results.append(result)
+                breakpoints[index] = breakpoint
             }
-            catch {
-                let result = DebugAdapter.Breakpoint(verified: false, reason: .failed)
-                results.append(result)
+        }
+        
+        var results: [DebugAdapter.Breakpoint] = []
+        var newBreakpoints: [Int: DebugAdapter.SourceBreakpoint] = [:]
+        
+        for (sourceBreakpoint, breakpoint) in zip(sourceBreakpointsRequested, breakpoints) {
+            guard let breakpoint else {
+                // Breakpoints can only be created in sources that have a path.
+                results.append(DebugAdapter.Breakpoint(verified: false, reason: .failed))
+                continue
             }
+            
+            let previous = previousBreakpoints[breakpoint.id]
+            if previous?.condition != sourceBreakpoint.condition || previous?.hitCondition != sourceBreakpoint.hitCondition || previous?.logMessage != sourceBreakpoint.logMessage {
+                setHitHandling(for: breakpoint, condition: sourceBreakpoint.condition, hitCondition: sourceBreakpoint.hitCondition, logMessage: sourceBreakpoint.logMessage)
+            }
+            
+            var result = adapterBreakpoint(for: breakpoint)
+            result.message = invalidHitConditionMessage(sourceBreakpoint.hitCondition)
+            
+            newBreakpoints[breakpoint.id] = sourceBreakpoint
+            results.append(result)
         }
         
-        for (id, _) in previousBreakpoints {
-           target.removeBreakpoint(id: id)
+        for id in previousIDs.values.joined() {
+            removeBreakpoint(id: id)
         }
         
         sourceBreakpoints[ref] = newBreakpoints.count > 0 ? newBreakpoints : nil
@@ -708,6 +1086,65 @@ final class Adapter: DebugAdapterServerRequestHandler {
         replyHandler(.success(.init(breakpoints: results)))
     }
     
+    /// Applies a breakpoint's condition, hit condition and log message.
+    ///
+    /// Conditions simple enough to check natively are checked by the breakpoint's hit handler, and
+    /// any other condition is left to LLDB. This restarts the count of hits, so it is only done when
+    /// the options change.
+    private func setHitHandling(for breakpoint: Breakpoint, condition: String?, hitCondition: String?, logMessage: String?) {
+        removeHitHandling(forBreakpointID: breakpoint.id)
+        
+        let fastCondition = condition.flatMap { BreakpointCondition($0) }
+        let hitCondition = hitCondition.flatMap { BreakpointHitHandler.HitCondition($0) }
+        let logMessage = logMessage.flatMap { $0.isEmpty ? nil : BreakpointHitHandler.LogMessage($0) }
+        
+        let handler = BreakpointHitHandler(condition: fastCondition, hitCondition: hitCondition, logMessage: logMessage) { [weak self] message in
+            DispatchQueue.main.async {
+                Array(message.utf8).withUnsafeBufferPointer { bytes in
+                    self?.logpointOutput?.append(bytes)
+                }
+            }
+        }
+        
+        breakpoint.condition = fastCondition == nil ? condition : nil
+        breakpoint.ignoreCount = handler?.ignoreCount ?? hitCondition?.ignoreCount ?? 0
+        breakpoint.autoContinue = logMessage != nil
+        
+        if let handler {
+            breakpointHitHandlers[breakpoint.id] = handler
+            breakpoint.setCallback(handler.callback)
+        }
+    }
+    
+    /// Removes a breakpoint the client no longer has, and forgets what was tracked for it, since LLDB
+    /// may give its ID to a later breakpoint.
+    private func removeBreakpoint(id: Int) {
+        removeHitHandling(forBreakpointID: id)
+        reportedBreakpoints[id] = nil
+        changedBreakpointIDs.remove(id)
+        target?.removeBreakpoint(id: id)
+    }
+    
+    private func removeHitHandling(forBreakpointID id: Int) {
+        guard let handler = breakpointHitHandlers.removeValue(forKey: id) else {
+            return
+        }
+        target?.findBreakpoint(id: id)?.setCallback(nil)
+        
+        // Callbacks only run while the process is running, so a handler removed at any other time
+        // can be released at once.
+        if let state = target?.process?.state, state == .running || state == .stepping {
+            retiredBreakpointHitHandlers.append(handler)
+        }
+    }
+    
+    private func invalidHitConditionMessage(_ hitCondition: String?) -> String? {
+        guard let hitCondition, !hitCondition.isEmpty, BreakpointHitHandler.HitCondition(hitCondition) == nil else {
+            return nil
+        }
+        return "Invalid hit condition “\(hitCondition)”."
+    }
+    
     func setFunctionBreakpoints(_ request: DebugAdapter.SetFunctionBreakpointsRequest, replyHandler: @escaping (Result<DebugAdapter.SetFunctionBreakpointsRequest.Result, Error>) -> Void) {
         guard let target else {
             replyHandler(.failure(AdapterError.notDebugging))
@@ -716,16 +1153,17 @@ final class Adapter: DebugAdapterServerRequestHandler {
         
         var results: [DebugAdapter.Breakpoint] = []
         var newBreakpoints: [Int: DebugAdapter.FunctionBreakpoint] = [:]
-        var previousBreakpoints = functionBreakpoints
+        var previousIDs: [String: [Int]] = [:]
+        for (id, functionBreakpoint) in functionBreakpoints {
+            previousIDs[functionBreakpoint.name, default: []].append(id)
+        }
         
         for functionBreakpoint in request.breakpoints {
             let name = functionBreakpoint.name
             
             let breakpoint: Breakpoint
-            if let match = previousBreakpoints.first(where: { $0.value.name == name }),
-                let bp = target.findBreakpoint(id: match.key) {
+            if let id = previousIDs[name]?.popLast(), let bp = target.findBreakpoint(id: id) {
                 breakpoint = bp
-                previousBreakpoints[match.key] = nil
             }
             else {
                 breakpoint = target.createBreakpoint(name: name)
@@ -734,16 +1172,20 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 try? breakpoint.addName(Self.breakpointLabel)
             }
             
-            breakpoint.condition = functionBreakpoint.condition
+            let previous = functionBreakpoints[breakpoint.id]
+            if previous?.condition != functionBreakpoint.condition || previous?.hitCondition != functionBreakpoint.hitCondition {
+                setHitHandling(for: breakpoint, condition: functionBreakpoint.condition, hitCondition: functionBreakpoint.hitCondition, logMessage: nil)
+            }
             
-            let result = adapterBreakpoint(for: breakpoint)
+            var result = adapterBreakpoint(for: breakpoint)
+            result.message = invalidHitConditionMessage(functionBreakpoint.hitCondition)
             
             newBreakpoints[breakpoint.id] = functionBreakpoint
             results.append(result)
         }
         
-        for (id, _) in previousBreakpoints {
-            target.removeBreakpoint(id: id)
+        for id in previousIDs.values.joined() {
+            removeBreakpoint(id: id)
         }
         
         functionBreakpoints = newBreakpoints
@@ -759,7 +1201,10 @@ final class Adapter: DebugAdapterServerRequestHandler {
         
         var results: [DebugAdapter.Breakpoint] = []
         var newBreakpoints: [Int: DebugAdapter.InstructionBreakpoint] = [:]
-        var previousBreakpoints = instructionBreakpoints
+        var previousIDs: [String: [Int]] = [:]
+        for (id, instructionBreakpoint) in instructionBreakpoints {
+            previousIDs[instructionBreakpoint.instructionReference, default: []].append(id)
+        }
         
         for instructionBreakpoint in request.breakpoints {
             do {
@@ -769,10 +1214,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 }
                 
                 let breakpoint: Breakpoint
-                if let match = previousBreakpoints.first(where: { $0.value.instructionReference == ref }),
-                   let bp = target.findBreakpoint(id: match.key) {
+                if let id = previousIDs[ref]?.popLast(), let bp = target.findBreakpoint(id: id) {
                     breakpoint = bp
-                    previousBreakpoints[match.key] = nil
                 }
                 else {
                     breakpoint = target.createBreakpoint(address: addr)
@@ -781,9 +1224,13 @@ final class Adapter: DebugAdapterServerRequestHandler {
                     try? breakpoint.addName(Self.breakpointLabel)
                 }
                 
-                breakpoint.condition = instructionBreakpoint.condition
+                let previous = instructionBreakpoints[breakpoint.id]
+                if previous?.condition != instructionBreakpoint.condition || previous?.hitCondition != instructionBreakpoint.hitCondition {
+                    setHitHandling(for: breakpoint, condition: instructionBreakpoint.condition, hitCondition: instructionBreakpoint.hitCondition, logMessage: nil)
+                }
                 
-                let result = adapterBreakpoint(for: breakpoint)
+                var result = adapterBreakpoint(for: breakpoint)
+                result.message = invalidHitConditionMessage(instructionBreakpoint.hitCondition)
                 
                 newBreakpoints[breakpoint.id] = instructionBreakpoint
                 results.append(result)
@@ -794,8 +1241,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
             }
         }
         
-        for (id, _) in previousBreakpoints {
-            target.removeBreakpoint(id: id)
+        for id in previousIDs.values.joined() {
+            removeBreakpoint(id: id)
         }
         
         instructionBreakpoints = newBreakpoints
@@ -903,7 +1350,10 @@ final class Adapter: DebugAdapterServerRequestHandler {
         
         var results: [DebugAdapter.Breakpoint] = []
         var newBreakpoints: [Int: DebugAdapter.DataBreakpoint] = [:]
-        var previousBreakpoints = dataBreakpoints
+        var previousIDs: [DataBreakpointKey: [Int]] = [:]
+        for (id, dataBreakpoint) in dataBreakpoints {
+            previousIDs[DataBreakpointKey(dataId: dataBreakpoint.dataId, accessType: dataBreakpoint.accessType), default: []].append(id)
+        }
         
         for dataBreakpoint in request.breakpoints {
             let dataId = dataBreakpoint.dataId
@@ -911,10 +1361,9 @@ final class Adapter: DebugAdapterServerRequestHandler {
             
             do {
                 let watchpoint: Watchpoint
-                if let match = previousBreakpoints.first(where: { $0.value.dataId == dataId && $0.value.accessType == accessType }),
-                   let wp = target.findWatchpoint(id: match.key) {
+                if let id = previousIDs[DataBreakpointKey(dataId: dataId, accessType: accessType)]?.popLast(),
+                   let wp = target.findWatchpoint(id: id) {
                     watchpoint = wp
-                    previousBreakpoints[match.key] = nil
                 }
                 else {
                     let comps = dataId.split(separator: "/", maxSplits: 1)
@@ -943,7 +1392,7 @@ final class Adapter: DebugAdapterServerRequestHandler {
             }
         }
         
-        for (id, _) in previousBreakpoints {
+        for id in previousIDs.values.joined() {
             target.removeWatchpoint(id: id)
         }
         
@@ -998,72 +1447,247 @@ final class Adapter: DebugAdapterServerRequestHandler {
         exceptionBreakpoints = newBreakpoints
         
         for (id, _) in previousBreakpoints {
-            target.removeBreakpoint(id: id)
+            removeBreakpoint(id: id)
         }
         
         replyHandler(.success(.init(breakpoints: results)))
     }
     
-    // MARK: - Sources and Variables
+    // MARK: - Modules
     
-    enum SourceReference: Hashable {
-        case path(String)
-        case ref(Int)
+    private var isSymbolLoadingDeferred = false
+    private var symbolLoadAllowList: [String] = []
+    
+    /// The modules reported to the client, by module ID.
+    private var adapterModules: [String: DebugAdapter.Module] = [:]
+    
+    /// The IDs of modules whose symbols were loaded after symbol loading was deferred.
+    private var modulesWithLoadedSymbols: Set<String> = []
+    
+    /// Parses the symbols of allow-listed modules, away from the main queue.
+    private let symbolLoadingQueue = DispatchQueue(label: "com.panic.debugadapter.symbols", qos: .utility)
+    
+    /// Sets whether new targets preload their modules' symbols. This must be done before the target is created.
+    private func prepareSymbolLoading(debugger: Debugger, isDeferred: Bool, allowList: [String]) throws {
+        isSymbolLoadingDeferred = isDeferred
+        symbolLoadAllowList = allowList
+        try debugger.setSetting("target.preload-symbols", value: isDeferred ? "false" : "true")
     }
     
-    private func adapterSource(for fileSpec: FileSpec) -> DebugAdapter.Source {
-        var source = DebugAdapter.Source()
-        source.name = fileSpec.filename
-        source.path = localPath(forRemotePath: fileSpec.path)
-        return source
+    private func isSymbolLoadAllowed(for module: Module) -> Bool {
+        guard let fileSpec = module.fileSpec else {
+            return false
+        }
+        let name = fileSpec.filename
+        let path = fileSpec.path
+        return symbolLoadAllowList.contains { pattern in
+            fnmatch(pattern, pattern.contains("/") ? path : name, 0) == 0
+        }
     }
     
-    private enum VariableContainer {
-        case stackFrame(Frame)
-        case locals(Frame)
-        case globals(Frame)
-        case registers(Frame)
-        case value(Value)
+    private func moduleID(for module: Module) -> String? {
+        return module.uuid ?? module.fileSpec?.path
     }
-    private var variables = ReferenceTree<Int, VariableContainer>()
     
-    private func findVariableValue(named name: String, in ref: Int) throws -> Value? {
-        guard let container = variables[ref] else {
-            throw AdapterError.invalidParameter("Invalid variable reference “\(ref)”.")
+    private func adapterModule(for module: Module) -> DebugAdapter.Module? {
+        guard let id = moduleID(for: module), let fileSpec = module.fileSpec else {
+            return nil
         }
         
-        switch container {
-            case let .locals(frame),
-                let .globals(frame),
-                let .registers(frame):
-                return frame.findVariable(named: name)
-                
-            case let .value(value):
-                return value.childMember(named: name)
-            
-            case .stackFrame(_):
-                return nil
+        var result = DebugAdapter.Module(id: .string(id), name: fileSpec.filename)
+        result.path = localPath(forRemotePath: fileSpec.path)
+        
+        let version = module.version
+        if !version.isEmpty {
+            result.version = version.map(String.init).joined(separator: ".")
         }
-    }
-    
-    private func parseAddress<S: StringProtocol>(from string: S) -> UInt64? {
-        if let r = string.range(of: "0x", options: [.anchored]) {
-            // Hexadecimal
-            return UInt64(string[r.upperBound...], radix: 16)
+        
+        if let target, let address = module.headerLoadAddress(in: target) {
+            result.addressRange = formatAddress(address)
+        }
+        
+        // Locating the symbol file of a deferred module could mean a search for its dSYM, so its status
+        // is not checked until its symbols have been loaded.
+        if isSymbolLoadingDeferred && !modulesWithLoadedSymbols.contains(id) {
+            result.symbolStatus = isSymbolLoadAllowed(for: module) ? "Loading symbols." : "Symbols deferred."
+        }
+        else if let symbolFileSpec = module.symbolFileSpec {
+            result.symbolStatus = "Symbols loaded."
+            result.symbolFilePath = localPath(forRemotePath: symbolFileSpec.path)
         }
         else {
-            // Decimal
-            return UInt64(string)
+            result.symbolStatus = "Symbols not found."
         }
+        
+        return result
     }
     
-    private func formatAddress(_ address: UInt64) -> String {
-        return "0x\(String(address, radix: 16))"
-    }
-    
-    // MARK: - Execution
-    
-    @MainActor
+    func modules(_ request: DebugAdapter.ModulesRequest, replyHandler: @escaping (Result<DebugAdapter.ModulesRequest.Result, Error>) -> Void) {
+        guard let target else {
+            replyHandler(.failure(AdapterError.notDebugging))
+            return
+        }
+        
+        let modules = target.modules
+        let start = min(max(request.startModule ?? 0, 0), modules.count)
+        let count = request.moduleCount.flatMap { $0 > 0 ? $0 : nil } ?? modules.count
+        let end = min(start + count, modules.count)
+        
+        var results: [DebugAdapter.Module] = []
+        for module in modules[start ..< end] {
+            guard let id = moduleID(for: module) else {
+                continue
+            }
+            if let cached = adapterModules[id] {
+                results.append(cached)
+            }
+            else if let result = adapterModule(for: module) {
+                adapterModules[id] = result
+                results.append(result)
+            }
+        }
+        
+        replyHandler(.success(.init(modules: results, totalModules: modules.count)))
+    }
+    
+    private func handleTargetEvent(_ event: TargetEvent) {
+        let eventType = event.eventType
+        
+        if !eventType.isDisjoint(with: [.modulesLoaded, .modulesUnloaded]) {
+            lineTableIndex.invalidateFileLookups()
+        }
+        
+        if eventType.contains(.modulesLoaded) {
+            for module in event.modules {
+                sendModuleEvent(for: module, reason: .new)
+            }
+            
+            if isSymbolLoadingDeferred {
+                preloadSymbols(for: event.modules.filter { isSymbolLoadAllowed(for: $0) })
+            }
+        }
+        
+        if eventType.contains(.symbolsLoaded) {
+            for module in event.modules {
+                if let id = moduleID(for: module) {
+                    modulesWithLoadedSymbols.insert(id)
+                }
+                sendModuleEvent(for: module, reason: .changed)
+            }
+        }
+        
+        if eventType.contains(.modulesUnloaded) {
+            for module in event.modules {
+                guard let id = moduleID(for: module) else {
+                    continue
+                }
+                modulesWithLoadedSymbols.remove(id)
+                
+                guard let result = adapterModules.removeValue(forKey: id) else {
+                    continue
+                }
+                connection.send(DebugAdapter.ModuleEvent(reason: .removed, module: result))
+            }
+        }
+    }
+    
+    /// Parses the symbols of `modules` on a background queue, so that large modules do not hold up
+    /// requests such as `pause` and `disconnect`, and reports each module again once it is done.
+    private func preloadSymbols(for modules: [Module]) {
+        guard !modules.isEmpty else {
+            return
+        }
+        
+        symbolLoadingQueue.async { [weak self] in
+            for module in modules {
+                module.preloadSymbols()
+                
+                DispatchQueue.main.async {
+                    // The module may have been unloaded while its symbols were parsed.
+                    guard let self, let id = self.moduleID(for: module), self.adapterModules[id] != nil else {
+                        return
+                    }
+                    self.modulesWithLoadedSymbols.insert(id)
+                    self.sendModuleEvent(for: module, reason: .changed)
+                }
+            }
+        }
+    }
+    
+    private func sendModuleEvent(for module: Module, reason: DebugAdapter.ModuleEvent.Reason) {
+        guard let id = moduleID(for: module), let result = adapterModule(for: module) else {
+            return
+        }
+        
+        // A module LLDB reports loading again, such as the executable once the process starts, is a change.
+        let previous = adapterModules.updateValue(result, forKey: id)
+        if previous == result {
+            return
+        }
+        connection.send(DebugAdapter.ModuleEvent(reason: previous == nil ? reason : .changed, module: result))
+    }
+    
+    // MARK: - Sources and Variables
+    
+    enum SourceReference: Hashable {
+        case path(String)
+        case ref(Int)
+    }
+    
+    private func adapterSource(for fileSpec: FileSpec) -> DebugAdapter.Source {
+        var source = DebugAdapter.Source()
+        source.name = fileSpec.filename
+        source.path = localPath(forRemotePath: fileSpec.path)
+        return source
+    }
+    
+    private enum VariableContainer {
+        case stackFrame(Frame)
+        case locals(Frame)
+        case globals(Frame)
+        case registers(Frame)
+        case value(Value)
+    }
+    /// Shared by every request lane, so all access takes its lock.
+    private let variables = Locked(HandleArena<VariableContainer>())
+    private let inspectionCache = Locked(InspectionCache())
+    
+    private func findVariableValue(named name: String, in ref: Int) throws -> Value? {
+        guard let container = variables.withLock({ $0.value(for: ref) }) else {
+            throw AdapterError.invalidParameter("Invalid variable reference “\(ref)”.")
+        }
+        
+        switch container {
+            case let .locals(frame),
+                let .globals(frame),
+                let .registers(frame):
+                return frame.findVariable(named: name)
+                
+            case let .value(value):
+                return value.childMember(named: name)
+            
+            case .stackFrame(_):
+                return nil
+        }
+    }
+    
+    private func parseAddress<S: StringProtocol>(from string: S) -> UInt64? {
+        if let r = string.range(of: "0x", options: [.anchored]) {
+            // Hexadecimal
+            return UInt64(string[r.upperBound...], radix: 16)
+        }
+        else {
+            // Decimal
+            return UInt64(string)
+        }
+    }
+    
+    private func formatAddress(_ address: UInt64) -> String {
+        return "0x\(String(address, radix: 16))"
+    }
+    
+    // MARK: - Execution
+    
     private func handleProcessEvent(_ event: ProcessEvent) {
         let process = event.process
         let eventType = event.eventType
@@ -1082,11 +1706,24 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 }
                 
                 if !event.isRestarted {
-                    sendStandardOutAndError(process)
+                    // Every callback for this stop has returned by the time it is reported.
+                    retiredBreakpointHitHandlers.removeAll()
+                    
+                    readStandardOutAndError(process)
+                    flushStandardOutAndError()
+                    
+                    // The client should see breakpoints as resolved by the time it sees the stop.
+                    flushBreakpointChanges()
+                    
                     sendThreadStoppedEvent()
                 }
                 
             case .exited:
+                retiredBreakpointHitHandlers.removeAll()
+                
+                readStandardOutAndError(process)
+                flushStandardOutAndError(isFinal: true)
+                
                 let processID = process.processID
                 if processID == nil || processID == restartingProcessID {
                     restartingProcessID = nil
@@ -1101,22 +1738,51 @@ final class Adapter: DebugAdapterServerRequestHandler {
             }
         }
         else if eventType.contains(.standardOut) || eventType.contains(.standardError) {
-            sendStandardOutAndError(process)
+            readStandardOutAndError(process)
+        }
+    }
+    
+    private var standardOutput: OutputCoalescer?
+    private var standardError: OutputCoalescer?
+    
+    /// Logpoint messages, which are batched and rate limited like the debuggee's own output.
+    private var logpointOutput: OutputCoalescer?
+    
+    /// Creates the coalescers for the debuggee's output from the `launch` or `attach` parameters.
+    private func prepareOutput(batchInterval: Int?, batchSize: Int?, rateLimit: Int?) {
+        var options = OutputCoalescer.Options()
+        if let batchInterval {
+            options.interval = TimeInterval(max(0, batchInterval)) / 1000
+        }
+        if let batchSize {
+            options.maximumLength = max(1, batchSize)
+        }
+        if let rateLimit {
+            options.rateLimit = rateLimit > 0 ? rateLimit : nil
+        }
+        
+        standardOutput = OutputCoalescer(options: options, queue: .main) { [weak self] string in
+            self?.output(string, category: .standardOutput)
+        }
+        standardError = OutputCoalescer(options: options, queue: .main) { [weak self] string in
+            self?.output(string, category: .standardError)
+        }
+        logpointOutput = OutputCoalescer(options: options, queue: .main) { [weak self] string in
+            self?.output(string, category: .console)
         }
     }
     
-    private func sendStandardOutAndError(_ process: SwiftLLDB.Process) {
-        withUnsafeTemporaryAllocation(of: CChar.self, capacity: 4096) { buffer in
+    private func readStandardOutAndError(_ process: SwiftLLDB.Process) {
+        withUnsafeTemporaryAllocation(of: CChar.self, capacity: 16384) { buffer in
             while true {
                 let count = process.readStandardOut(buffer)
                 guard count > 0 else {
                     break
                 }
                 
-                let string = buffer[0 ..< count].withMemoryRebound(to: UInt8.self) { asciiBuffer in
-                    String(decoding: asciiBuffer, as: Unicode.ASCII.self)
+                buffer[0 ..< count].withMemoryRebound(to: UInt8.self) { bytes in
+                    standardOutput?.append(UnsafeBufferPointer(bytes))
                 }
-                output(string, category: .standardOutput)
             }
             
             while true {
@@ -1125,14 +1791,20 @@ final class Adapter: DebugAdapterServerRequestHandler {
                     break
                 }
                 
-                let string = buffer[0 ..< count].withMemoryRebound(to: UInt8.self) { asciiBuffer in
-                    String(decoding: asciiBuffer, as: Unicode.ASCII.self)
+                buffer[0 ..< count].withMemoryRebound(to: UInt8.self) { bytes in
+                    standardError?.append(UnsafeBufferPointer(bytes))
                 }
-                output(string, category: .standardError)
             }
         }
     }
     
+    /// Sends buffered output immediately, so it is delivered before any event that follows.
+    private func flushStandardOutAndError(isFinal: Bool = false) {
+        standardOutput?.flush(isFinal: isFinal)
+        standardError?.flush(isFinal: isFinal)
+        logpointOutput?.flush(isFinal: isFinal)
+    }
+    
     private func sendProcessEvent(_ process: SwiftLLDB.Process, startMethod: DebugAdapter.ProcessEvent.StartMethod) {
         var event = DebugAdapter.ProcessEvent(name: process.info.name)
         event.startMethod = startMethod
@@ -1214,8 +1886,48 @@ final class Adapter: DebugAdapterServerRequestHandler {
         connection.send(DebugAdapter.TerminatedEvent())
     }
     
+    // Requests that change the debuggee while it is stopped tell the client exactly what changed, so
+    // that it fetches only the affected memory, variables or stack again, rather than everything.
+    
+    /// Reports memory written by a request, which may hold any variable, in any thread.
+    private func sendMemoryChanged(memoryReference: String, offset: Int = 0, count: Int) {
+        if clientOptions.supportsMemoryEvent, count > 0 {
+            connection.send(DebugAdapter.MemoryEvent(memoryReference: memoryReference, offset: offset, count: count))
+        }
+        sendVariablesChanged(threadID: nil)
+    }
+    
+    /// Reports that variables changed, in one thread if `threadID` is given.
+    private func sendVariablesChanged(threadID: Int?) {
+        guard clientOptions.supportsInvalidatedEvent else {
+            return
+        }
+        var event = DebugAdapter.InvalidatedEvent()
+        event.areas = [.variables]
+        event.threadId = threadID
+        connection.send(event)
+    }
+    
+    /// Reports that a thread's stack changed, as a stop for clients that do not support invalidation.
+    private func sendStacksChanged(threadID: Int, reason: DebugAdapter.StoppedEvent.Reason) {
+        guard clientOptions.supportsInvalidatedEvent else {
+            var event = DebugAdapter.StoppedEvent(reason: reason)
+            event.allThreadsStopped = true
+            event.threadId = threadID
+            connection.send(event)
+            return
+        }
+        var event = DebugAdapter.InvalidatedEvent()
+        event.areas = [.stacks]
+        event.threadId = threadID
+        connection.send(event)
+    }
+    
     private func willContinue() {
-        variables.removeAll()
+        variables.withLock { $0.endStop() }
+        inspectionCache.withLock { $0.invalidate() }
+        memoryCache.invalidate()
+        gotoTargetLocations.removeAll()
     }
     
     func pause(_ request: DebugAdapter.PauseRequest, replyHandler: @escaping (Result<(), Error>) -> Void) {
@@ -1319,6 +2031,69 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
     }
     
+    /// Locations offered by the last `gotoTargets` request during the current stop, keyed by target ID.
+    private var gotoTargetLocations: [Int: (path: String, line: Int)] = [:]
+    private var nextGotoTargetID = 1
+    
+    func gotoTargets(_ request: DebugAdapter.GotoTargetsRequest, replyHandler: @escaping (Result<DebugAdapter.GotoTargetsRequest.Result, Error>) -> Void) {
+        guard let target else {
+            replyHandler(.failure(AdapterError.notDebugging))
+            return
+        }
+        
+        guard let path = request.source.path else {
+            replyHandler(.success(.init(targets: [])))
+            return
+        }
+        
+        let line = clientOptions.linesStartAt1 ? request.line : request.line + 1
+        let lldbPath = remotePath(forLocalPath: path)
+        
+        // A line can only be jumped to if it has code.
+        let positions = lineTableIndex.positions(inFileAt: lldbPath, from: .init(line: line, column: nil), through: .init(line: line, column: .max), in: target)
+        guard !positions.isEmpty else {
+            replyHandler(.success(.init(targets: [])))
+            return
+        }
+        
+        let id = nextGotoTargetID
+        nextGotoTargetID += 1
+        gotoTargetLocations = [id: (lldbPath, line)]
+        
+        let filename = (path as NSString).lastPathComponent
+        let gotoTarget = DebugAdapter.GotoTarget(id: id, label: "\(filename):\(line)", line: request.line)
+        replyHandler(.success(.init(targets: [gotoTarget])))
+    }
+    
+    func goto(_ request: DebugAdapter.GotoRequest, replyHandler: @escaping (Result<(), Error>) -> Void) {
+        do {
+            guard let process = target?.process else {
+                throw AdapterError.notDebugging
+            }
+            
+            let threadID = request.threadId
+            guard let thread = process.thread(withID: threadID) else {
+                throw AdapterError.invalidParameter("Invalid thread ID “\(threadID)”.")
+            }
+            
+            guard let location = gotoTargetLocations[request.targetId], let fileSpec = FileSpec(path: location.path) else {
+                throw AdapterError.invalidParameter("Invalid goto target “\(request.targetId)”.")
+            }
+            
+            try thread.jump(to: fileSpec, line: location.line)
+            
+            // The thread's frames moved, but no values changed.
+            inspectionCache.withLock { $0.invalidate() }
+            
+            replyHandler(.success(()))
+            
+            sendStacksChanged(threadID: threadID, reason: .goto)
+        }
+        catch {
+            replyHandler(.failure(error))
+        }
+    }
+    
     func terminate(_ request: DebugAdapter.TerminateRequest, replyHandler: @escaping (Result<(), Error>) -> Void) {
         do {
             guard let process = target?.process else {
@@ -1358,68 +2133,114 @@ final class Adapter: DebugAdapterServerRequestHandler {
             return
         }
         
-        let frames = thread.frames.enumerated().map { (index, frame) in
-            let key = "[\(thread.indexID), \(index)]"
-            let ref = variables.insert(parent: nil, key: key, value: .stackFrame(frame))
-            
-            var debugFrame = DebugAdapter.StackFrame(id: ref)
-            
-            var name: String
-            if let displayName = frame.displayFunctionName {
-                name = displayName
-            }
-            else if let pc = frame.programCounter {
-                name = formatAddress(pc)
-            }
-            else {
-                name = "<unknown>"
-            }
-            
-            if frame.function?.isOptimized ?? false {
-                name += " [opt]"
-            }
-            
-            debugFrame.name = name
-            
-            if let lineEntry = frame.lineEntry,
-               let fileSpec = lineEntry.fileSpec,
-               let line = lineEntry.line, line != 0 {
-                // A zero-value line means the source is compiler generated.
-                debugFrame.source = adapterSource(for: fileSpec)
-                
-                debugFrame.line = clientOptions.linesStartAt1 ? line : line - 1
+        // Frames are unwound one at a time, and no further than the requested window.
+        let startFrame = max(0, request.startFrame ?? 0)
+        let levels = request.levels ?? 0
+        let (windowEnd, windowOverflow) = startFrame.addingReportingOverflow(max(0, levels))
+        let endFrame = levels > 0 && !windowOverflow ? windowEnd : Int.max
+        
+        var frames: [DebugAdapter.StackFrame] = []
+        do {
+            var index = startFrame
+            while index < endFrame {
+                try checkCancellation()
                 
-                if let column = lineEntry.column {
-                    debugFrame.column = clientOptions.columnsStartAt1 ? column : column - 1
+                if let cachedFrame = inspectionCache.withLock({ $0.frame(threadID: threadID, index: index) }) {
+                    frames.append(cachedFrame)
+                }
+                else if inspectionCache.withLock({ $0.hasFrame(threadID: threadID, index: index) }) == false {
+                    break
+                }
+                else if let frame = thread.frame(at: index) {
+                    let stackFrame = stackFrame(for: frame, at: index, in: thread)
+                    inspectionCache.withLock { $0.setFrame(stackFrame, threadID: threadID, index: index) }
+                    frames.append(stackFrame)
+                }
+                else {
+                    inspectionCache.withLock { $0.setFrameCount(index, threadID: threadID) }
+                    break
                 }
+                index += 1
             }
+        }
+        catch {
+            replyHandler(.failure(error))
+            return
+        }
+        
+        // When frames remain beyond the window, estimate one more window so the client offers to load them.
+        let totalFrames: Int
+        if frames.count == levels,
+           inspectionCache.withLock({ $0.hasFrame(threadID: threadID, index: endFrame) }) ?? (thread.frame(at: endFrame) != nil) {
+            let (estimate, overflow) = endFrame.addingReportingOverflow(levels)
+            totalFrames = overflow ? Int.max : estimate
+        }
+        else {
+            totalFrames = startFrame + frames.count
+        }
+        
+        replyHandler(.success(.init(stackFrames: frames, totalFrames: totalFrames)))
+    }
+    
+    private func stackFrame(for frame: Frame, at index: Int, in thread: SwiftLLDB.Thread) -> DebugAdapter.StackFrame {
+        let key = "[\(thread.indexID), \(index)]"
+        let ref = variables.withLock { $0.insert(parent: nil, key: key, value: .stackFrame(frame)) }
+        
+        var debugFrame = DebugAdapter.StackFrame(id: ref)
+        
+        var name: String
+        if let displayName = frame.displayFunctionName {
+            name = displayName
+        }
+        else if let pc = frame.programCounter {
+            name = formatAddress(pc)
+        }
+        else {
+            name = "<unknown>"
+        }
+        
+        if frame.function?.isOptimized ?? false {
+            name += " [opt]"
+        }
+        
+        debugFrame.name = name
+        
+        if let lineEntry = frame.lineEntry,
+           let fileSpec = lineEntry.fileSpec,
+           let line = lineEntry.line, line != 0 {
+            // A zero-value line means the source is compiler generated.
+            debugFrame.source = adapterSource(for: fileSpec)
             
-            if frame.isArtificial {
-                debugFrame.presentationHint = .subtle
-            }
+            debugFrame.line = clientOptions.linesStartAt1 ? line : line - 1
             
-            if let pc = frame.programCounter {
-                debugFrame.instructionPointerReference = formatAddress(pc)
+            if let column = lineEntry.column {
+                debugFrame.column = clientOptions.columnsStartAt1 ? column : column - 1
             }
-            
-            var attributes: [DebugAdapter.StackFrame.Attribute] = []
-            
-            if let data = frame.languageSpecificData {
-                if data["IsSwiftAsyncFunction"]?.asBool() ?? false {
-                    attributes.append(.async)
-                }
+        }
+        
+        if frame.isArtificial {
+            debugFrame.presentationHint = .subtle
+        }
+        
+        if let pc = frame.programCounter {
+            debugFrame.instructionPointerReference = formatAddress(pc)
+        }
+        
+        var attributes: [DebugAdapter.StackFrame.Attribute] = []
+        
+        if let data = frame.languageSpecificData {
+            if data["IsSwiftAsyncFunction"]?.asBool() ?? false {
+                attributes.append(.async)
             }
-            
-            debugFrame.attributes = attributes
-            
-            return debugFrame
         }
         
-        replyHandler(.success(.init(stackFrames: frames)))
+        debugFrame.attributes = attributes
+        
+        return debugFrame
     }
     
     private func frame(withID id: Int) throws -> Frame {
-        guard case let .stackFrame(frame) = variables[id] else {
+        guard case let .stackFrame(frame) = variables.withLock({ $0.value(for: id) }) else {
             throw AdapterError.invalidParameter("Invalid stack frame ID “\(id)”.")
         }
         return frame
@@ -1485,15 +2306,15 @@ final class Adapter: DebugAdapterServerRequestHandler {
             let frameID = request.frameId
             let frame = try self.frame(withID: frameID)
             
-            let localsRef = variables.insert(parent: frameID, key: "._locals", value: .locals(frame))
+            let localsRef = variables.withLock { $0.insert(parent: frameID, key: "._locals", value: .locals(frame)) }
             var localsScope = DebugAdapter.Scope(name: "Locals", variablesReference: localsRef)
             localsScope.presentationHint = .locals
             
-            let globalsRef = variables.insert(parent: frameID, key: "._globals", value: .globals(frame))
+            let globalsRef = variables.withLock { $0.insert(parent: frameID, key: "._globals", value: .globals(frame)) }
             var globalsScope = DebugAdapter.Scope(name: "Globals", variablesReference: globalsRef)
             globalsScope.presentationHint = .globals
             
-            let registersRef = variables.insert(parent: frameID, key: "._registers", value: .registers(frame))
+            let registersRef = variables.withLock { $0.insert(parent: frameID, key: "._registers", value: .registers(frame)) }
             var registersScope = DebugAdapter.Scope(name: "Registers", variablesReference: registersRef)
             registersScope.presentationHint = .registers
             
@@ -1513,19 +2334,25 @@ final class Adapter: DebugAdapterServerRequestHandler {
             }
             
             let ref = request.variablesReference
-            guard let container = variables[ref] else {
+            guard let container = variables.withLock({ $0.value(for: ref) }) else {
                 throw AdapterError.invalidParameter("Invalid variable reference “\(ref)”.")
             }
             
             let format = request.format
             
-            let variables: [DebugAdapter.Variable]
+            let cacheKey = InspectionCache.ChildrenKey(containerRef: ref, isHex: format?.hex ?? false, filter: request.filter, start: request.start, count: request.count)
+            if let snapshots = inspectionCache.withLock({ $0.children(for: cacheKey) }) {
+                replyHandler(.success(.init(variables: snapshots.map { variable(for: $0) })))
+                return
+            }
+            
+            let snapshots: [InspectionCache.ValueSnapshot]
             switch container {
                 case let .locals(frame):
-                    variables = self.variables(for: frame.variables(for: [.arguments, .locals], inScopeOnly: true), in: ref, format: format)
+                    snapshots = try self.snapshots(of: frame.variables(for: [.arguments, .locals], inScopeOnly: true), in: ref, format: format)
                     
                 case let .globals(frame):
-                    variables = self.variables(for: frame.variables(for: [.statics], inScopeOnly: true), in: ref, format: format)
+                    snapshots = try self.snapshots(of: frame.variables(for: [.statics], inScopeOnly: true), in: ref, format: format)
                     
                 case let .registers(frame):
                     let registers = frame.registers
@@ -1546,15 +2373,19 @@ final class Adapter: DebugAdapterServerRequestHandler {
                         }
                     }
                     
-                    variables = self.variables(for: registers, in: ref, format: format)
+                    snapshots = try self.snapshots(of: registers, in: ref, format: format)
                     
                 case let .value(value):
-                    variables = self.variables(for: value.children, in: ref, format: format)
+                    let children = self.children(of: value, filter: request.filter, start: request.start, count: request.count)
+                    snapshots = try self.snapshots(of: children, in: ref, format: format)
                 
                 case .stackFrame(_):
-                    variables = []
+                    snapshots = []
             }
             
+            inspectionCache.withLock { $0.setChildren(snapshots, for: cacheKey) }
+            
+            let variables = snapshots.map { variable(for: $0) }
             replyHandler(.success(.init(variables: variables)))
         }
         catch {
@@ -1562,29 +2393,67 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
     }
     
-    private func variables<S>(for values: S, in containerRef: Int, format: DebugAdapter.ValueFormat?) -> [DebugAdapter.Variable] where S: Sequence, S.Element == Value {
-        var nameCounts: [String: Int] = [:]
-        
-        for value in values {
-            let name = value.name ?? "<null>"
-            nameCounts[name, default: 0] += 1
+    /// Containers with more children than this are paged by the client.
+    private static let pagingThreshold = 100
+    
+    /// The most children ever reported, since the protocol's child counts are 32-bit integers.
+    private static let maximumChildCount = Int(Int32.max)
+    
+    /// The numbers of children to report as `indexedVariables` and `namedVariables`.
+    ///
+    /// Only arrays, vectors and values with synthetic children, such as standard library collections,
+    /// can be paged, and are when they have many children named by index. Structs, unions and classes
+    /// report their members as named children. Other values are not counted at all, since counting the
+    /// children of every variable would cost a query each just to find out it is not worth paging.
+    private func childCounts(of value: Value) -> (indexed: Int?, named: Int?) {
+        let dataType = value.dataType
+        let isPageable = value.isSynthetic || (dataType?.isArray ?? false) || (dataType?.isVector ?? false)
+        let isAggregate = dataType?.isAggregate ?? false
+        guard isPageable || isAggregate else {
+            return (nil, nil)
         }
         
-        return values.map { v in
-            var name = v.name ?? "<null>"
-            
-            // If the same name is used multiple times, provide more information.
-            if nameCounts[name] ?? 0 > 1 {
-                if let declaration = v.declaration {
-                    if let filename = declaration.fileSpec?.filename,
-                       let line = declaration.line {
-                        name += " @ \(filename):\(line)"
-                    }
-                    else if let location = v.location {
-                        name += " @ \(location)"
-                    }
-                }
+        let count = value.childCount(max: Self.maximumChildCount)
+        if isPageable, count > Self.pagingThreshold,
+           let name = value.child(at: 0)?.name, name.hasPrefix("[") {
+            return (count, 0)
+        }
+        return (nil, value.isSynthetic || isAggregate ? count : nil)
+    }
+    
+    /// The children of a value within the window requested by the client.
+    /// Children are fetched individually, so only those in the window are realized.
+    private func children(of value: Value, filter: DebugAdapter.VariablesRequest.Filter?, start: Int?, count: Int?) -> [Value] {
+        let total: Int
+        if let indexedCount = childCounts(of: value).indexed {
+            if filter == .named {
+                return []
+            }
+            total = indexedCount
+        }
+        else {
+            if filter == .indexed {
+                return []
             }
+            total = value.childCount(max: Self.maximumChildCount)
+        }
+        
+        // A missing or zero count requests every remaining child.
+        let lowerBound = min(max(0, start ?? 0), total)
+        let upperBound = count.flatMap { $0 > 0 ? min(total, lowerBound + $0) : nil } ?? total
+        
+        return (lowerBound ..< upperBound).compactMap { value.child(at: $0) }
+    }
+    
+    /// Reads each value from LLDB once, producing snapshots whose children are registered under `containerRef`.
+    private func snapshots<S>(of values: S, in containerRef: Int, format: DebugAdapter.ValueFormat?) throws -> [InspectionCache.ValueSnapshot] where S: Sequence, S.Element == Value {
+        let values = Array(values)
+        var snapshots: [InspectionCache.ValueSnapshot] = []
+        snapshots.reserveCapacity(values.count)
+        var nameCounts: [String: Int] = [:]
+        
+        for v in values {
+            try checkCancellation()
             
             // Swap the default format to hex if requested (and vice-versa).
             switch v.format {
@@ -1596,48 +2465,89 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 break
             }
             
-            let displayTypeName = v.displayTypeName
+            let name = v.name ?? "<null>"
+            nameCounts[name, default: 0] += 1
             
-            var displayValue = ""
-            if let error = v.error {
-                displayValue += "<error: \(error)>"
-            }
-            else {
-                let value = v.value
-                let summary = v.summary
-                
-                if let value, !value.isEmpty {
-                    displayValue += value
-                    if let summary, !summary.isEmpty {
-                        displayValue += " \(summary)"
+            let error = v.error
+            snapshots.append(InspectionCache.ValueSnapshot(
+                name: name,
+                typeName: v.displayTypeName,
+                value: error == nil ? v.value : nil,
+                summary: error == nil ? v.summary : nil,
+                error: error,
+                loadAddress: v.loadAddress,
+                expressionPath: v.expressionPath,
+                hasChildren: v.mightHaveChildren
+            ))
+        }
+        
+        for index in snapshots.indices {
+            let v = values[index]
+            
+            // If the same name is used multiple times, provide more information.
+            if nameCounts[snapshots[index].name] ?? 0 > 1 {
+                if let declaration = v.declaration {
+                    if let filename = declaration.fileSpec?.filename,
+                       let line = declaration.line {
+                        snapshots[index].name += " @ \(filename):\(line)"
                     }
-                }
-                else if let summary, !summary.isEmpty {
-                    displayValue += summary
-                }
-                else if let displayTypeName, !displayTypeName.isEmpty {
-                    displayValue += displayTypeName
-                    if let loadAddr = v.loadAddress {
-                        displayValue += " @ \(formatAddress(loadAddr))"
+                    else if let location = v.location {
+                        snapshots[index].name += " @ \(location)"
                     }
                 }
             }
             
-            var variable = DebugAdapter.Variable(name: name, value: displayValue)
-            
-            variable.type = displayTypeName.flatMap { !$0.isEmpty ? $0 : nil } ?? "<no-type>"
-            variable.evaluateName = v.expressionPath
-            
-            if v.mightHaveChildren {
-                variable.variablesReference = variables.insert(parent: containerRef, key: name, value: .value(v))
+            if snapshots[index].hasChildren {
+                let name = snapshots[index].name
+                snapshots[index].variablesReference = variables.withLock { $0.insert(parent: containerRef, key: name, value: .value(v)) }
+                (snapshots[index].indexedChildCount, snapshots[index].namedChildCount) = childCounts(of: v)
             }
+        }
+        
+        return snapshots
+    }
+    
+    private func variable(for snapshot: InspectionCache.ValueSnapshot) -> DebugAdapter.Variable {
+        let displayTypeName = snapshot.typeName
+        
+        var displayValue = ""
+        if let error = snapshot.error {
+            displayValue += "<error: \(error)>"
+        }
+        else {
+            let value = snapshot.value
+            let summary = snapshot.summary
             
-            if let loadAddr = v.loadAddress {
-                variable.memoryReference = formatAddress(loadAddr)
+            if let value, !value.isEmpty {
+                displayValue += value
+                if let summary, !summary.isEmpty {
+                    displayValue += " \(summary)"
+                }
+            }
+            else if let summary, !summary.isEmpty {
+                displayValue += summary
+            }
+            else if let displayTypeName, !displayTypeName.isEmpty {
+                displayValue += displayTypeName
+                if let loadAddr = snapshot.loadAddress {
+                    displayValue += " @ \(formatAddress(loadAddr))"
+                }
             }
-            
-            return variable
         }
+        
+        var variable = DebugAdapter.Variable(name: snapshot.name, value: displayValue)
+        
+        variable.type = displayTypeName.flatMap { !$0.isEmpty ? $0 : nil } ?? "<no-type>"
+        variable.evaluateName = snapshot.expressionPath
+        variable.variablesReference = snapshot.variablesReference
+        variable.indexedVariables = snapshot.indexedChildCount
+        variable.namedVariables = snapshot.namedChildCount
+        
+        if let loadAddr = snapshot.loadAddress {
+            variable.memoryReference = formatAddress(loadAddr)
+        }
+        
+        return variable
     }
     
     func completions(_ request: DebugAdapter.CompletionsRequest, replyHandler: @escaping (Result<DebugAdapter.CompletionsRequest.Result, Error>) -> Void) {
@@ -1716,6 +2626,12 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 result = try evaluateExpression(expression, frame: frame)
             }
             
+            if request.context == .repl {
+                // Commands and expressions typed by the user may change any value.
+                inspectionCache.withLock { $0.invalidateValues() }
+                memoryCache.invalidate()
+            }
+            
             replyHandler(.success(result))
         }
         catch {
@@ -1767,7 +2683,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
         var result = DebugAdapter.EvaluateRequest.Result(result: summary)
         result.type = v.displayTypeName
         if v.mightHaveChildren {
-            result.variablesReference = variables.insert(parent: nil, key: expression, value: .value(v))
+            result.variablesReference = variables.withLock { $0.insert(parent: nil, key: expression, value: .value(v)) }
+            (result.indexedVariables, result.namedVariables) = childCounts(of: v)
         }
         
         return result
@@ -1779,7 +2696,7 @@ final class Adapter: DebugAdapterServerRequestHandler {
             let ref = request.variablesReference
             
             let v: Value?
-            switch variables[ref] {
+            switch variables.withLock({ $0.value(for: ref) }) {
             case let .value(value):
                 v = value.childMember(named: name)
             case let .locals(frame), let .globals(frame):
@@ -1794,22 +2711,36 @@ final class Adapter: DebugAdapterServerRequestHandler {
             
             let value = request.value
             try v.setValue(value)
+            inspectionCache.withLock { $0.invalidateValues() }
+            memoryCache.invalidate()
             
             let summary = v.summary ?? v.value ?? ""
             
             var result = DebugAdapter.SetVariableRequest.Result(value: summary)
             result.type = v.displayTypeName
             if v.mightHaveChildren {
-                result.variablesReference = variables.insert(parent: ref, key: childName, value: .value(v))
+                result.variablesReference = variables.withLock { $0.insert(parent: ref, key: childName, value: .value(v)) }
+                (result.indexedVariables, result.namedVariables) = childCounts(of: v)
             }
             
             replyHandler(.success(result))
+            
+            if let addr = v.loadAddress {
+                sendMemoryChanged(memoryReference: formatAddress(addr), count: v.byteSize)
+            }
+            else {
+                // A value held in a register is only visible in its own thread.
+                sendVariablesChanged(threadID: v.frame?.thread.id)
+            }
         }
         catch {
             replyHandler(.failure(error))
         }
     }
     
+    /// Disassembly of whole symbols, shared across requests and sessions of the same modules.
+    private let disassemblyCache = DisassemblyCache()
+    
     func disassemble(_ request: DebugAdapter.DisassembleRequest, replyHandler: @escaping (Result<DebugAdapter.DisassembleRequest.Result?, Error>) -> Void) {
         do {
             guard let target else {
@@ -1828,68 +2759,18 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 addr += UInt64(offset)
             }
             
-            guard let address = Address(at: addr, in: target) else {
+            guard Address(at: addr, in: target) != nil else {
                 throw AdapterError.invalidParameter("Memory reference not valid for the target binary.")
             }
             
-            let instructionOffset = request.instructionOffset ?? 0
-            let instructionCount = request.instructionCount
             let resolveSymbols = request.resolveSymbols ?? false
             
-            guard let instructions = target.readInstructions(at: address, count: instructionOffset + instructionCount) else {
-                throw AdapterError.invalidParameter("Could not read instructions for memory reference “\(request.memoryReference)”.")
-            }
+            var disassembledInstructions = try disassemblyCache.instructions(at: addr, instructionOffset: request.instructionOffset ?? 0, count: request.instructionCount, in: target, checkCancellation: checkCancellation)
             
-            let disassembledInstructions = instructions.dropFirst(instructionOffset).map { instruction in
-                let instAddr = instruction.address
-                let loadAddr = instAddr?.loadAddress(for: target)
-                
-                let addrStr = formatAddress(loadAddr ?? 0)
-                
-                var instStr = ""
-                var symbolStr: String?
-                
-                if let symbol = instAddr?.symbol, symbol.startAddress == instAddr {
-                    // Prepend the symbol name to the first line.
-                    instStr += symbol.mangledName ?? symbol.name ?? "" + ": "
-                    symbolStr = symbol.displayName
-                }
-                
-                let mnemonic = instruction.mnemonic(for: target) ?? ""
-                if mnemonic.count < 7 {
-                    // Pad
-                    instStr += String(repeating: " ", count: 7 - mnemonic.count) + mnemonic
-                }
-                else {
-                    instStr += mnemonic
-                }
-                
-                let operands = instruction.operands(for: target) ?? ""
-                if mnemonic.count < 12 {
-                    // Pad
-                    instStr += String(repeating: " ", count: 12 - operands.count) + operands
-                }
-                else {
-                    instStr += operands
-                }
-                
-                if let comment = instruction.comment(for: target), !comment.isEmpty {
-                    instStr += " ; \(comment)"
-                }
-                
-                var disassembledInstruction = DebugAdapter.DisassembledInstruction(address: addrStr, instruction: instStr)
-                
-                if let data = instruction.data(for: target) {
-                    disassembledInstruction.instructionBytes = data.reduce(into: "") { partialResult, byte in
-                        partialResult.append(String(format: "%2.2x", byte))
-                    }
-                }
-                
-                if resolveSymbols {
-                    disassembledInstruction.symbol = symbolStr
+            if !resolveSymbols {
+                for index in disassembledInstructions.indices {
+                    disassembledInstructions[index].symbol = nil
                 }
-                
-                return disassembledInstruction
             }
             
             let result = DebugAdapter.DisassembleRequest.Result(instructions: disassembledInstructions)
@@ -1900,6 +2781,9 @@ final class Adapter: DebugAdapterServerRequestHandler {
         }
     }
     
+    /// Memory read during the current stop, shared by requests for overlapping windows.
+    private let memoryCache = MemoryCache()
+    
     func readMemory(_ request: DebugAdapter.ReadMemoryRequest, replyHandler: @escaping (Result<DebugAdapter.ReadMemoryRequest.Result?, Error>) -> Void) {
         do {
             guard let target, let process = target.process else {
@@ -1920,14 +2804,14 @@ final class Adapter: DebugAdapterServerRequestHandler {
             
             let count = request.count
             
-            let result = try withUnsafeTemporaryAllocation(byteCount: count, alignment: 8) { buffer in
-                let read = try process.readMemory(buffer, at: addr)
-                
-                var result = DebugAdapter.ReadMemoryRequest.Result(address: formatAddress(addr))
-                result.unreadableBytes = count - read
-                result.data = Data(bytesNoCopy: buffer.baseAddress!, count: read, deallocator: .none).base64EncodedString()
-                return result
+            var encoder = Base64Encoder(expectedByteCount: count)
+            let (_, unreadableCount) = memoryCache.read(at: addr, count: count, from: process) { bytes in
+                encoder.append(bytes)
             }
+            
+            var result = DebugAdapter.ReadMemoryRequest.Result(address: formatAddress(addr))
+            result.unreadableBytes = unreadableCount
+            result.data = encoder.finalize()
             replyHandler(.success(result))
         }
         catch {
@@ -1959,24 +2843,130 @@ final class Adapter: DebugAdapterServerRequestHandler {
             
             let result = try data.withUnsafeBytes { bytes in
                 let written = try process.writeMemory(bytes, at: addr)
+                inspectionCache.withLock { $0.invalidateValues() }
+                disassemblyCache.invalidate(addresses: addr ..< addr + UInt64(written))
+                memoryCache.invalidate(addresses: addr ..< addr + UInt64(written))
                 
                 var result = DebugAdapter.WriteMemoryRequest.Result()
                 result.bytesWritten = written
                 return result
             }
             replyHandler(.success(result))
+            
+            sendMemoryChanged(memoryReference: request.memoryReference, offset: request.offset ?? 0, count: result.bytesWritten ?? 0)
+        }
+        catch {
+            replyHandler(.failure(error))
+        }
+    }
+    
+    /// Identifies the progress events of each memory search.
+    private let nextMemorySearchID = Locked(1)
+    
+    /// A custom request that searches a stopped process's memory for bytes or a typed value.
+    /// Runs on the evaluation lane, reporting progress and checking for cancellation between chunks.
+    private func searchMemory(_ arguments: MemorySearch.Arguments?, replyHandler: @escaping (Result<MemorySearch.Result?, Error>) -> Void) {
+        do {
+            guard let target, let process = target.process else {
+                throw AdapterError.notDebugging
+            }
+            
+            guard let arguments else {
+                throw AdapterError.invalidParameter("A search requires either data, or a value and its type.")
+            }
+            
+            let search = try MemorySearch(arguments, byteOrder: process.byteOrder, addressByteSize: process.addressByteSize)
+            
+            var progressID: String?
+            var lastPercentage = 0
+            if clientOptions.supportsProgressReporting {
+                let id = nextMemorySearchID.withLock { id in
+                    defer { id += 1 }
+                    return "icarus.searchMemory.\(id)"
+                }
+                progressID = id
+                
+                var event = DebugAdapter.ProgressStartEvent(progressId: id, title: "Searching Memory")
+                event.percentage = 0
+                connection.send(event)
+            }
+            
+            defer {
+                if let progressID {
+                    connection.send(DebugAdapter.ProgressEndEvent(progressId: progressID))
+                }
+            }
+            
+            let result = try search.run(in: process, formatAddress: formatAddress, checkCancellation: checkCancellation) { fraction in
+                let percentage = Int(fraction * 100)
+                guard let progressID, percentage > lastPercentage else {
+                    return
+                }
+                lastPercentage = percentage
+                
+                var event = DebugAdapter.ProgressUpdateEvent(progressId: progressID)
+                event.percentage = percentage
+                connection.send(event)
+            }
+            replyHandler(.success(result))
         }
         catch {
             replyHandler(.failure(error))
         }
     }
     
+    // MARK: - Statistics
+    
+    /// A custom request that reports LLDB's target statistics along with the adapter's own timings and
+    /// cache counts, as JSON with stable keys so that two sessions can be compared.
+    static let statisticsCommand = "icarus/statistics"
+    
+    private struct StatisticsArguments: Codable, Sendable {
+        /// Whether LLDB omits its per-module and per-breakpoint details.
+        var summaryOnly: Bool?
+    }
+    
+    /// Latency and payload sizes of each request command, recorded by the connection on its own queue.
+    private let responseStatistics = Locked(ResponseStatistics())
+    
+    private func statistics(summaryOnly: Bool) -> JSONValue {
+        var lldbStatistics: JSONValue = .null
+        if let json = target?.statistics(summaryOnly: summaryOnly)?.jsonString {
+            lldbStatistics = (try? JSONDecoder().decode(JSONValue.self, from: Data(json.utf8))) ?? .null
+        }
+        
+        var hitHandlers: [String: JSONValue] = [:]
+        for (id, handler) in breakpointHitHandlers {
+            hitHandlers[String(id)] = handler.statistics.jsonSummary
+        }
+        
+        return [
+            "lldb": lldbStatistics,
+            "requests": responseStatistics.withLock { $0.jsonSummary },
+            "output": (connection.transport as? DebugAdapterFileHandleTransport)?.writeQueueStatus.jsonSummary ?? .null,
+            "events": [
+                "all": eventLatency.jsonSummary,
+                "stops": stopLatency.jsonSummary,
+            ],
+            "inspectionCache": inspectionCache.withLock { $0.statistics.jsonSummary },
+            "disassemblyCache": disassemblyCache.statistics.jsonSummary,
+            "memoryCache": memoryCache.statistics.jsonSummary,
+            "variables": variables.withLock { $0.statistics.jsonSummary },
+            "breakpoints": [
+                "lineTableIndex": lineTableIndex.statistics.jsonSummary,
+                "hitHandlers": .object(hitHandlers),
+            ],
+            "progress": progressReporter?.jsonSummary ?? [:],
+        ]
+    }
+    
     // MARK: - Errors
     
     enum AdapterError: LocalizedError {
         case notDebugging
         case invalidated
         case invalidParameter(String)
+        case postmortem
         
         var errorDescription: String? {
             switch self {
@@ -1986,6 +2976,8 @@ final class Adapter: DebugAdapterServerRequestHandler {
                 return "The session has ended."
             case let .invalidParameter(reason):
                 return reason
+            case .postmortem:
+                return "A core file cannot be run or modified."
             }
         }
     }
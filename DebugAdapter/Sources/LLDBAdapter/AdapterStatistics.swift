@@ -0,0 +1,162 @@
+import Foundation
+
+/// Counts and times the responses to each request command, as measured by the connection.
+struct ResponseStatistics {
+    struct Entry {
+        var latency = LatencyHistogram()
+        var failureCount = 0
+        var requestLength = 0
+        var responseLength = 0
+        var maximumResponseLength = 0
+    }
+    
+    private(set) var entries: [String: Entry] = [:]
+    
+    mutating func record(_ metrics: DebugAdapterConnection.ResponseMetrics) {
+        var entry = entries[metrics.command] ?? Entry()
+        entry.latency.record(metrics.duration)
+        entry.failureCount += metrics.isSuccess ? 0 : 1
+        entry.requestLength += metrics.requestLength
+        entry.responseLength += metrics.responseLength
+        entry.maximumResponseLength = max(entry.maximumResponseLength, metrics.responseLength)
+        entries[metrics.command] = entry
+    }
+    
+    var jsonSummary: JSONValue {
+        return .object(entries.mapValues { entry in
+            var summary = entry.latency.jsonSummary
+            if case var .object(fields) = summary {
+                fields["failureCount"] = .number(Double(entry.failureCount))
+                fields["requestBytes"] = .number(Double(entry.requestLength))
+                fields["responseBytes"] = .number(Double(entry.responseLength))
+                fields["maximumResponseBytes"] = .number(Double(entry.maximumResponseLength))
+                summary = .object(fields)
+            }
+            return summary
+        })
+    }
+}
+
+// MARK: - Summaries
+//
+// Each summary is plain JSON with stable keys, and durations in milliseconds, so that the output of
+// two runs can be compared with a text diff.
+
+extension LatencyHistogram {
+    var jsonSummary: JSONValue {
+        return [
+            "count": .number(Double(count)),
+            "meanMs": mean.map { .number($0.milliseconds) } ?? .null,
+            "p50Ms": percentile(0.5).map { .number($0.milliseconds) } ?? .null,
+            "p95Ms": percentile(0.95).map { .number($0.milliseconds) } ?? .null,
+            "maxMs": .number(maximum.milliseconds),
+        ]
+    }
+}
+
+extension InspectionCache.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "frameHits": .number(Double(frameHits)),
+            "frameMisses": .number(Double(frameMisses)),
+            "frameHitRate": Self.rate(frameHits, frameMisses),
+            "childrenHits": .number(Double(childrenHits)),
+            "childrenMisses": .number(Double(childrenMisses)),
+            "childrenHitRate": Self.rate(childrenHits, childrenMisses),
+        ]
+    }
+    
+    private static func rate(_ hits: Int, _ misses: Int) -> JSONValue {
+        return hits + misses > 0 ? .number(Double(hits) / Double(hits + misses)) : .null
+    }
+}
+
+extension DisassemblyCache.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "hitCount": .number(Double(hitCount)),
+            "missCount": .number(Double(missCount)),
+            "disassembledInstructionCount": .number(Double(disassembledInstructionCount)),
+            "disassemblyMs": .number(disassemblyDuration.milliseconds),
+        ]
+    }
+}
+
+extension MemoryCache.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "pageHits": .number(Double(pageHits)),
+            "pageMisses": .number(Double(pageMisses)),
+            "bytesRead": .number(Double(bytesRead)),
+            "readMs": .number(readDuration.milliseconds),
+        ]
+    }
+}
+
+extension DebugAdapterMessageWriter.Status {
+    var jsonSummary: JSONValue {
+        return [
+            "pendingMessageCount": .number(Double(pendingMessageCount)),
+            "pendingBytes": .number(Double(pendingByteCount)),
+            "peakPendingBytes": .number(Double(peakPendingByteCount)),
+            "writtenMessageCount": .number(Double(writtenMessageCount)),
+            "writeCallCount": .number(Double(writeCallCount)),
+            "backpressureCount": .number(Double(backpressureCount)),
+        ]
+    }
+}
+
+extension HandleArena.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "liveHandleCount": .number(Double(liveHandleCount)),
+            "slotCount": .number(Double(slotCount)),
+            "evictionCount": .number(Double(evictionCount)),
+        ]
+    }
+}
+
+extension LineTableIndex.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "indexedCompileUnitCount": .number(Double(indexedCompileUnitCount)),
+            "indexedLineEntryCount": .number(Double(indexedLineEntryCount)),
+            "indexMs": .number(indexDuration.milliseconds),
+            "lookupCount": .number(Double(lookupCount)),
+            "lookupMs": .number(lookupDuration.milliseconds),
+        ]
+    }
+}
+
+extension BreakpointHitHandler.Statistics {
+    var jsonSummary: JSONValue {
+        return [
+            "hitCount": .number(Double(hitCount)),
+            "conditionPassCount": .number(Double(conditionPassCount)),
+            "conditionFallbackCount": .number(Double(conditionFallbackCount)),
+            "triggerCount": .number(Double(triggerCount)),
+            "overhead": overhead.jsonSummary,
+        ]
+    }
+}
+
+extension ProgressReporter {
+    /// The number of tasks and the total time taken, by title.
+    var jsonSummary: JSONValue {
+        var totals: [String: (count: Int, duration: Duration)] = [:]
+        for timing in timings {
+            totals[timing.title, default: (0, .zero)].count += 1
+            totals[timing.title, default: (0, .zero)].duration += timing.duration
+        }
+        return .object(totals.mapValues { total in
+            ["count": .number(Double(total.count)), "totalMs": .number(total.duration.milliseconds)]
+        })
+    }
+}
+
+extension Duration {
+    fileprivate var milliseconds: Double {
+        let (seconds, attoseconds) = components
+        return Double(seconds) * 1e3 + Double(attoseconds) / 1e15
+    }
+}
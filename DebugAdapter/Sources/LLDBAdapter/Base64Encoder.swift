@@ -0,0 +1,69 @@
+import Foundation
+
+/// Encodes bytes as base64 as they arrive, so that a large read is never collected into one buffer
+/// before being encoded.
+struct Base64Encoder {
+    private static let alphabet = Array("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".utf8)
+    
+    private var output: [UInt8] = []
+    
+    /// Bytes left over from the last chunk that do not yet fill a group of three.
+    private var carry: UInt32 = 0
+    private var carryCount = 0
+    
+    init(expectedByteCount: Int = 0) {
+        output.reserveCapacity((expectedByteCount + 2) / 3 * 4)
+    }
+    
+    mutating func append(_ bytes: UnsafeRawBufferPointer) {
+        var index = bytes.startIndex
+        
+        while carryCount > 0, index < bytes.endIndex {
+            carry = carry << 8 | UInt32(bytes[index])
+            carryCount += 1
+            index += 1
+            
+            if carryCount == 3 {
+                appendGroup(carry)
+                carry = 0
+                carryCount = 0
+            }
+        }
+        
+        while bytes.endIndex - index >= 3 {
+            appendGroup(UInt32(bytes[index]) << 16 | UInt32(bytes[index + 1]) << 8 | UInt32(bytes[index + 2]))
+            index += 3
+        }
+        
+        while index < bytes.endIndex {
+            carry = carry << 8 | UInt32(bytes[index])
+            carryCount += 1
+            index += 1
+        }
+    }
+    
+    /// Pads the final group and returns the encoded string.
+    mutating func finalize() -> String {
+        switch carryCount {
+        case 1:
+            appendGroup(carry << 16, characterCount: 2)
+            output.append(UInt8(ascii: "="))
+            output.append(UInt8(ascii: "="))
+        case 2:
+            appendGroup(carry << 8, characterCount: 3)
+            output.append(UInt8(ascii: "="))
+        default:
+            break
+        }
+        carry = 0
+        carryCount = 0
+        
+        return String(decoding: output, as: UTF8.self)
+    }
+    
+    private mutating func appendGroup(_ group: UInt32, characterCount: Int = 4) {
+        for shift in stride(from: 18, to: 18 - characterCount * 6, by: -6) {
+            output.append(Self.alphabet[Int(group >> UInt32(shift) & 0x3f)])
+        }
+    }
+}
@@ -0,0 +1,337 @@
+import ArgumentParser
+import Foundation
+import SwiftLLDB
+
+struct BenchmarkCommand: ParsableCommand {
+    static var configuration = CommandConfiguration(commandName: "benchmark", abstract: "Measures the cost of adapter internals.", subcommands: [
+        FramingBenchmark.self,
+        DecodingBenchmark.self,
+        ConditionBenchmark.self,
+        MemoryBenchmark.self,
+    ])
+}
+
+extension BenchmarkCommand {
+    /// Frames a growing backlog of buffered messages, which should cost the same per message regardless of backlog size.
+    struct FramingBenchmark: ParsableCommand {
+        static var configuration = CommandConfiguration(commandName: "framing", abstract: "Measures per-message framing cost as the read backlog grows.")
+        
+        @Option(help: "The size in bytes of each message's content.")
+        var messageSize = 256
+        
+        @Option(help: "The size in bytes of each transport read, or 0 to deliver the whole backlog in one read.")
+        var chunkSize = 0
+        
+        @Option(help: "The number of times each backlog is framed.")
+        var iterations = 20
+        
+        func run() throws {
+            print("backlog     messages/s    ns/message")
+            
+            for backlog in [1, 10, 100, 1_000, 10_000, 100_000] {
+                let stream = Self.stream(messageCount: backlog, messageSize: messageSize)
+                let readLength = chunkSize > 0 ? chunkSize : stream.count
+                let reads = stride(from: 0, to: stream.count, by: readLength).map { offset in
+                    stream.subdata(in: offset ..< min(offset + readLength, stream.count))
+                }
+                
+                var messageCount = 0
+                let duration = try ContinuousClock().measure {
+                    for _ in 0 ..< iterations {
+                        var framer = DebugAdapterMessageFramer()
+                        for data in reads {
+                            try framer.append(data) { _ in
+                                messageCount += 1
+                            }
+                        }
+                    }
+                }
+                
+                let nanoseconds = duration.nanoseconds / Double(messageCount)
+                print(String(format: "%-10d  %12.0f  %12.1f", backlog, 1e9 / nanoseconds, nanoseconds))
+            }
+        }
+        
+        private static func stream(messageCount: Int, messageSize: Int) -> Data {
+            var stream = Data()
+            for seq in 1 ... messageCount {
+                let prefix = "{\"seq\":\(seq),\"type\":\"request\",\"command\":\"variables\",\"arguments\":{\"variablesReference\":1000,\"padding\":\""
+                let suffix = "\"}}"
+                let padding = String(repeating: "x", count: max(0, messageSize - prefix.utf8.count - suffix.utf8.count))
+                let content = Data((prefix + padding + suffix).utf8)
+                stream.append(Data("Content-Length: \(content.count)\r\n\r\n".utf8))
+                stream.append(content)
+            }
+            return stream
+        }
+    }
+}
+
+extension BenchmarkCommand {
+    /// Compares the cost of routing and decoding each request type with a single typed decode against
+    /// a full envelope decode followed by a second full decode of the typed message.
+    struct DecodingBenchmark: ParsableCommand {
+        static var configuration = CommandConfiguration(commandName: "decoding", abstract: "Measures per-request decoding cost by request type.")
+        
+        @Option(help: "The number of times each request is decoded.")
+        var iterations = 20_000
+        
+        private struct Envelope: Decodable {
+            let type: String
+            let seq: Int
+            let command: String
+        }
+        
+        private struct Message<Arguments: Decodable>: Decodable {
+            let seq: Int
+            let arguments: Arguments?
+        }
+        
+        func run() throws {
+            print("command                 bytes   single (ns)   double (ns)")
+            
+            let breakpoints = (1 ... 50).map { "{\"line\":\($0 * 10)}" }.joined(separator: ",")
+            let environment = (1 ... 50).map { "\"VARIABLE_\($0)\":\"value \($0)\"" }.joined(separator: ",")
+            
+            try measure(DebugAdapter.ThreadsRequest.self, arguments: nil)
+            try measure(DebugAdapter.StackTraceRequest.self, arguments: "{\"threadId\":1,\"startFrame\":0,\"levels\":20}")
+            try measure(DebugAdapter.ScopesRequest.self, arguments: "{\"frameId\":1000}")
+            try measure(DebugAdapter.VariablesRequest.self, arguments: "{\"variablesReference\":1000,\"filter\":\"indexed\",\"start\":0,\"count\":100}")
+            try measure(DebugAdapter.EvaluateRequest.self, arguments: "{\"expression\":\"request->header.id\",\"frameId\":1000,\"context\":\"watch\"}")
+            try measure(DebugAdapter.SetBreakpointsRequest.self, arguments: "{\"source\":{\"path\":\"/Users/example/Project/Sources/main.c\"},\"breakpoints\":[\(breakpoints)]}")
+            try measure(DebugAdapter.LaunchRequest<Adapter.LaunchParameters>.self, arguments: "{\"program\":\"/Users/example/Project/build/example\",\"args\":[\"--verbose\"],\"env\":{\(environment)}}")
+        }
+        
+        private func measure<Request: DebugAdapterRequest>(_ requestType: Request.Type, arguments: String?) throws {
+            var content = "{\"seq\":42,\"type\":\"request\",\"command\":\"\(Request.command)\""
+            if let arguments {
+                content += ",\"arguments\":\(arguments)"
+            }
+            content += "}"
+            let data = Data(content.utf8)
+            
+            let clock = ContinuousClock()
+            
+            let single = try clock.measure {
+                for _ in 0 ..< iterations {
+                    let envelope = try DebugAdapterMessageEnvelope(scanning: data)
+                    if let range = envelope.payloadRange {
+                        _ = try JSONDecoder().decode(Request.self, from: data[range])
+                    }
+                    else {
+                        _ = try Request.init()
+                    }
+                }
+            }
+            
+            let double = try clock.measure {
+                for _ in 0 ..< iterations {
+                    _ = try JSONDecoder().decode(Envelope.self, from: data)
+                    let message = try JSONDecoder().decode(Message<Request>.self, from: data)
+                    _ = try message.arguments ?? Request.init()
+                }
+            }
+            
+            let command = Request.command.padding(toLength: 20, withPad: " ", startingAt: 0)
+            print(command + String(format: "  %7d  %12.0f  %12.0f", data.count, single.nanoseconds / Double(iterations), double.nanoseconds / Double(iterations)))
+        }
+    }
+}
+
+extension BenchmarkCommand {
+    /// Runs a program to completion three times: without a breakpoint, with a conditional breakpoint
+    /// evaluated by LLDB, and with the same condition checked by the adapter's native fast path.
+    struct ConditionBenchmark: ParsableCommand {
+        static var configuration = CommandConfiguration(commandName: "conditions", abstract: "Measures conditional breakpoint evaluation throughput.", discussion: """
+            The program should hit the breakpoint many times and write little output, so that the run time is dominated by condition evaluation.
+            """)
+        
+        @Option(help: "The program to run.")
+        var program: String
+        
+        @Option(help: "The breakpoint location, as “file:line”.")
+        var location: String
+        
+        @Option(help: "The breakpoint condition, such as “i == 1000000”.")
+        var condition: String
+        
+        @Argument(help: "Arguments passed to the program.")
+        var arguments: [String] = []
+        
+        func validate() throws {
+            guard BreakpointCondition(condition) != nil else {
+                throw ValidationError("The condition “\(condition)” is not one the adapter checks natively.")
+            }
+            guard let separator = location.lastIndex(of: ":"), Int(location[location.index(after: separator)...]) != nil else {
+                throw ValidationError("The location “\(location)” is not of the form “file:line”.")
+            }
+        }
+        
+        func run() throws {
+            try Debugger.initialize()
+            defer {
+                Debugger.terminate()
+            }
+            
+            let separator = location.lastIndex(of: ":")!
+            let path = String(location[..<separator])
+            let line = Int(location[location.index(after: separator)...])!
+            
+            let baseline = try measure(path: path, line: line) { _ in }
+            
+            let lldb = try measure(path: path, line: line) { breakpoint in
+                breakpoint.condition = condition
+            }
+            
+            var handler: BreakpointHitHandler?
+            let fast = try measure(path: path, line: line) { breakpoint in
+                handler = BreakpointHitHandler(condition: BreakpointCondition(condition), hitCondition: nil, logMessage: nil) { _ in }
+                breakpoint.setCallback(handler?.callback)
+            }
+            
+            let evaluations = handler?.statistics.hitCount ?? 0
+            guard evaluations > 0 else {
+                print("The breakpoint was not hit.")
+                return
+            }
+            
+            print("mode        run time (ms)   evaluations/s   µs/evaluation")
+            print(String(format: "baseline    %13.1f", baseline.nanoseconds / 1e6))
+            for (mode, duration) in [("lldb", lldb), ("fast path", fast)] {
+                let nanoseconds = max(duration.nanoseconds - baseline.nanoseconds, 1) / Double(evaluations)
+                print(mode.padding(toLength: 10, withPad: " ", startingAt: 0) + String(format: "  %13.1f  %14.0f  %14.2f", duration.nanoseconds / 1e6, 1e9 / nanoseconds, nanoseconds / 1e3))
+            }
+        }
+        
+        /// Launches the program synchronously and resumes it at every stop until it exits.
+        private func measure(path: String, line: Int, configure: (Breakpoint) -> Void) throws -> Duration {
+            let debugger = Debugger()
+            debugger.isAsynchronous = false
+            
+            let target = try debugger.createTarget(path: program)
+            
+            var options = Target.LaunchOptions()
+            options.arguments = arguments
+            
+            return try ContinuousClock().measure {
+                let breakpoint = target.createBreakpoint(path: path, line: line)
+                configure(breakpoint)
+                
+                let process = try target.launch(with: options)
+                while process.state == .stopped {
+                    try process.resume()
+                }
+            }
+        }
+    }
+}
+
+extension BenchmarkCommand {
+    /// Reads the largest readable region of a stopped process in overlapping windows, as a memory view
+    /// does while scrolling, comparing single reads encoded through `Data` with the adapter's page cache
+    /// and streaming base64 encoder.
+    struct MemoryBenchmark: ParsableCommand {
+        static var configuration = CommandConfiguration(commandName: "memory", abstract: "Measures readMemory throughput against a local process.")
+        
+        @Option(help: "The program to run.")
+        var program: String
+        
+        @Option(help: "The breakpoint location, as “file:line”, at which memory is read.")
+        var location: String
+        
+        @Option(help: "The size in bytes of each read.")
+        var readSize = 64 * 1024
+        
+        @Option(help: "The most bytes of the region to read.")
+        var regionSize = 64 << 20
+        
+        @Argument(help: "Arguments passed to the program.")
+        var arguments: [String] = []
+        
+        func validate() throws {
+            guard readSize > 1 else {
+                throw ValidationError("The read size must be at least 2 bytes.")
+            }
+            guard let separator = location.lastIndex(of: ":"), Int(location[location.index(after: separator)...]) != nil else {
+                throw ValidationError("The location “\(location)” is not of the form “file:line”.")
+            }
+        }
+        
+        func run() throws {
+            try Debugger.initialize()
+            defer {
+                Debugger.terminate()
+            }
+            
+            let separator = location.lastIndex(of: ":")!
+            let path = String(location[..<separator])
+            let line = Int(location[location.index(after: separator)...])!
+            
+            let debugger = Debugger()
+            debugger.isAsynchronous = false
+            
+            let target = try debugger.createTarget(path: program)
+            _ = target.createBreakpoint(path: path, line: line)
+            
+            var options = Target.LaunchOptions()
+            options.arguments = arguments
+            
+            let process = try target.launch(with: options)
+            defer {
+                try? process.kill()
+            }
+            guard process.state == .stopped else {
+                print("The breakpoint was not hit.")
+                return
+            }
+            
+            guard let region = process.memoryRegions.filter(\.isReadable).max(by: { $0.range.count < $1.range.count }) else {
+                print("The process has no readable memory regions.")
+                return
+            }
+            
+            // Each window overlaps the previous one by half.
+            let start = region.range.lowerBound
+            let end = start + min(UInt64(regionSize), UInt64(region.range.count))
+            let windows = stride(from: start, to: end, by: readSize / 2).map { address in
+                (address, Int(min(UInt64(readSize), end - address)))
+            }
+            let byteCount = windows.reduce(0) { $0 + $1.1 }
+            
+            let single = ContinuousClock().measure {
+                for (address, count) in windows {
+                    withUnsafeTemporaryAllocation(byteCount: count, alignment: 8) { buffer in
+                        let read = (try? process.readMemory(buffer, at: address)) ?? 0
+                        _ = Data(bytesNoCopy: buffer.baseAddress!, count: read, deallocator: .none).base64EncodedString()
+                    }
+                }
+            }
+            
+            var cache = MemoryCache()
+            let readWithCache = {
+                for (address, count) in windows {
+                    var encoder = Base64Encoder(expectedByteCount: count)
+                    _ = cache.read(at: address, count: count, from: process) { bytes in
+                        encoder.append(bytes)
+                    }
+                    _ = encoder.finalize()
+                }
+            }
+            let cold = ContinuousClock().measure(readWithCache)
+            let warm = ContinuousClock().measure(readWithCache)
+            
+            print("Read \(byteCount) bytes in \(windows.count) windows of \(region.name ?? "an unnamed region").")
+            print("mode          MB/s")
+            for (mode, duration) in [("single read", single), ("cache (cold)", cold), ("cache (warm)", warm)] {
+                print(mode.padding(toLength: 12, withPad: " ", startingAt: 0) + String(format: "  %8.1f", Double(byteCount) / 1e6 / (duration.nanoseconds / 1e9)))
+            }
+        }
+    }
+}
+
+extension Duration {
+    fileprivate var nanoseconds: Double {
+        let (seconds, attoseconds) = components
+        return Double(seconds) * 1e9 + Double(attoseconds) / 1e9
+    }
+}
@@ -0,0 +1,314 @@
+import Foundation
+import SwiftLLDB
+
+/// A breakpoint condition simple enough to check without the expression parser: a variable path
+/// compared with an integer constant, such as `i == 1234`, `ptr != nullptr` or `req->id == 42`, or a
+/// variable path tested on its own, such as `isReady` or `!ptr`.
+///
+/// The path is read with `Frame.findValue(forVariablePath:)` and compared natively, which costs a few
+/// microseconds where a full expression is compiled and run in the debuggee on every hit.
+struct BreakpointCondition: Equatable {
+    enum Comparison: String, CaseIterable {
+        case equal = "=="
+        case notEqual = "!="
+        case lessThanOrEqual = "<="
+        case greaterThanOrEqual = ">="
+        case lessThan = "<"
+        case greaterThan = ">"
+        
+        /// The comparison with its operands swapped, so that `42 < i` can be checked as `i > 42`.
+        var swapped: Comparison {
+            switch self {
+            case .equal, .notEqual:
+                return self
+            case .lessThanOrEqual:
+                return .greaterThanOrEqual
+            case .greaterThanOrEqual:
+                return .lessThanOrEqual
+            case .lessThan:
+                return .greaterThan
+            case .greaterThan:
+                return .lessThan
+            }
+        }
+        
+        func compare<T: Comparable>(_ lhs: T, _ rhs: T) -> Bool {
+            switch self {
+            case .equal:
+                return lhs == rhs
+            case .notEqual:
+                return lhs != rhs
+            case .lessThanOrEqual:
+                return lhs <= rhs
+            case .greaterThanOrEqual:
+                return lhs >= rhs
+            case .lessThan:
+                return lhs < rhs
+            case .greaterThan:
+                return lhs > rhs
+            }
+        }
+    }
+    
+    /// The condition as written, which LLDB evaluates when the fast path cannot.
+    let expression: String
+    
+    let path: String
+    let comparison: Comparison
+    let operand: Int64
+    
+    /// Recognizes `expression`, returning `nil` if it needs the expression parser.
+    init?(_ expression: String) {
+        var scanner = ConditionScanner(expression)
+        scanner.skipWhitespace()
+        
+        let path: String
+        let comparison: Comparison
+        let operand: Int64
+        
+        if scanner.scan("!"), !scanner.scan("=") {
+            scanner.skipWhitespace()
+            guard let p = scanner.scanPath() else {
+                return nil
+            }
+            path = p
+            comparison = .equal
+            operand = 0
+        }
+        else if let p = scanner.scanPath() {
+            scanner.skipWhitespace()
+            if scanner.isAtEnd {
+                path = p
+                comparison = .notEqual
+                operand = 0
+            }
+            else {
+                guard let c = scanner.scanComparison() else {
+                    return nil
+                }
+                scanner.skipWhitespace()
+                guard let o = scanner.scanConstant() else {
+                    return nil
+                }
+                path = p
+                comparison = c
+                operand = o
+            }
+        }
+        else {
+            scanner = ConditionScanner(expression)
+            scanner.skipWhitespace()
+            guard let o = scanner.scanConstant() else {
+                return nil
+            }
+            scanner.skipWhitespace()
+            guard let c = scanner.scanComparison() else {
+                return nil
+            }
+            scanner.skipWhitespace()
+            guard let p = scanner.scanPath() else {
+                return nil
+            }
+            path = p
+            comparison = c.swapped
+            operand = o
+        }
+        
+        scanner.skipWhitespace()
+        guard scanner.isAtEnd else {
+            return nil
+        }
+        
+        self.expression = expression
+        self.path = path
+        self.comparison = comparison
+        self.operand = operand
+    }
+    
+    /// Checks the condition in `frame`, or returns `nil` if the path does not name an integer, pointer
+    /// or enumeration whose signedness is known, in which case LLDB must evaluate the condition instead.
+    func evaluate(in frame: Frame) -> Bool? {
+        guard let value = frame.findValue(forVariablePath: path), value.error == nil, let type = value.dataType else {
+            return nil
+        }
+        
+        // Compare as the value's own type does. An operand outside the type's range would be converted
+        // by C's usual arithmetic conversions, so such comparisons are left to LLDB.
+        let isSigned: Bool
+        if type.isPointer {
+            isSigned = false
+        }
+        else if let isSignedInteger = type.isSignedInteger {
+            isSigned = isSignedInteger
+        }
+        else {
+            return nil
+        }
+        
+        let bitWidth = Int(type.byteSize) * 8
+        guard bitWidth > 0, bitWidth <= 64 else {
+            return nil
+        }
+        
+        if isSigned {
+            guard bitWidth == 64 || (operand >= -(1 << (bitWidth - 1)) && operand < 1 << (bitWidth - 1)) else {
+                return nil
+            }
+            guard let signed = try? value.valueAsSigned() else {
+                return nil
+            }
+            return comparison.compare(signed, operand)
+        }
+        else {
+            guard bitWidth == 64 || (operand >= 0 && operand < 1 << bitWidth) else {
+                return nil
+            }
+            guard let unsigned = try? value.valueAsUnsigned() else {
+                return nil
+            }
+            return comparison.compare(unsigned, UInt64(bitPattern: operand))
+        }
+    }
+}
+
+extension BreakpointCondition {
+    /// Scans the small grammar of conditions that are checked without the expression parser.
+    private struct ConditionScanner {
+        private let characters: [Character]
+        private var index = 0
+        
+        init(_ string: String) {
+            self.characters = Array(string)
+        }
+        
+        var isAtEnd: Bool {
+            return index >= characters.count
+        }
+        
+        private var current: Character? {
+            return index < characters.count ? characters[index] : nil
+        }
+        
+        mutating func skipWhitespace() {
+            while let c = current, c.isWhitespace {
+                index += 1
+            }
+        }
+        
+        mutating func scan(_ literal: String) -> Bool {
+            let literal = Array(literal)
+            guard index + literal.count <= characters.count, Array(characters[index ..< index + literal.count]) == literal else {
+                return false
+            }
+            index += literal.count
+            return true
+        }
+        
+        private mutating func scanIdentifier() -> String? {
+            guard let first = current, first.isLetter || first == "_" || first == "$" else {
+                return nil
+            }
+            let start = index
+            while let c = current, c.isLetter || c.isNumber || c == "_" || c == "$" {
+                index += 1
+            }
+            return String(characters[start ..< index])
+        }
+        
+        private static let keywords: Set<String> = ["true", "false", "nullptr", "NULL", "nil", "sizeof"]
+        
+        /// Scans a path such as `a`, `a.b`, `a->b` or `a[3].b`.
+        mutating func scanPath() -> String? {
+            let start = index
+            guard let head = scanIdentifier(), !Self.keywords.contains(head) else {
+                index = start
+                return nil
+            }
+            
+            while true {
+                let componentStart = index
+                if scan("->") || scan(".") {
+                    guard scanIdentifier() != nil else {
+                        index = componentStart
+                        return nil
+                    }
+                }
+                else if scan("[") {
+                    let digitsStart = index
+                    while let c = current, c.isASCII, c.isNumber {
+                        index += 1
+                    }
+                    guard index > digitsStart, scan("]") else {
+                        index = start
+                        return nil
+                    }
+                }
+                else {
+                    break
+                }
+            }
+            
+            return String(characters[start ..< index])
+        }
+        
+        mutating func scanComparison() -> Comparison? {
+            for comparison in Comparison.allCases where scan(comparison.rawValue) {
+                return comparison
+            }
+            return nil
+        }
+        
+        /// Scans an integer, character or boolean literal, or a null pointer constant.
+        mutating func scanConstant() -> Int64? {
+            for (keyword, value) in [("nullptr", 0), ("NULL", 0), ("nil", 0), ("true", 1), ("false", 0)] as [(String, Int64)] {
+                let start = index
+                if scan(keyword) {
+                    if let c = current, c.isLetter || c.isNumber || c == "_" {
+                        index = start
+                        continue
+                    }
+                    return value
+                }
+            }
+            
+            if scan("'") {
+                guard let c = current, c != "\\", c != "'", let ascii = c.asciiValue else {
+                    return nil
+                }
+                index += 1
+                return scan("'") ? Int64(ascii) : nil
+            }
+            
+            let isNegative = scan("-")
+            var radix = 10
+            if scan("0x") || scan("0X") {
+                radix = 16
+            }
+            
+            let start = index
+            while let c = current, c.isHexDigit {
+                index += 1
+            }
+            let digits = String(characters[start ..< index])
+            
+            // Leave octal literals to LLDB.
+            guard !digits.isEmpty, radix == 16 || digits == "0" || !digits.hasPrefix("0"),
+                  let magnitude = UInt64(digits, radix: radix) else {
+                return nil
+            }
+            
+            // Integer suffixes do not change the value.
+            while let c = current, "uUlL".contains(c) {
+                index += 1
+            }
+            
+            if isNegative {
+                guard magnitude <= UInt64(Int64.max) + 1 else {
+                    return nil
+                }
+                return magnitude == UInt64(Int64.max) + 1 ? Int64.min : -Int64(magnitude)
+            }
+            return Int64(bitPattern: magnitude)
+        }
+    }
+}
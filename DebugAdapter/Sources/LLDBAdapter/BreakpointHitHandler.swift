@@ -0,0 +1,285 @@
+import Foundation
+import SwiftLLDB
+
+/// Applies a breakpoint's condition, hit condition and log message inside the adapter, as each hit
+/// happens, so none of them requires a stop and a round trip through the client.
+///
+/// Conditions that `BreakpointCondition` recognizes are checked natively instead of being compiled by
+/// LLDB. Hit conditions that only skip the first hits are given to LLDB as an ignore count; the rest
+/// are counted by the handler. A breakpoint with a log message is a logpoint: its message is
+/// formatted and sent as output, and the debuggee continues without stopping.
+final class BreakpointHitHandler: @unchecked Sendable {
+    struct HitCondition: Equatable {
+        enum Comparison: String, CaseIterable {
+            case equal = "=="
+            case greaterThanOrEqual = ">="
+            case lessThanOrEqual = "<="
+            case greaterThan = ">"
+            case lessThan = "<"
+            case multiple = "%"
+        }
+        
+        var comparison: Comparison
+        var count: Int
+        
+        /// Parses conditions such as `5`, `>= 5` or `% 5`. A bare count stops from that hit on.
+        init?(_ string: String) {
+            var string = string.trimmingCharacters(in: .whitespaces)
+            
+            var comparison = Comparison.greaterThanOrEqual
+            if let match = Comparison.allCases.first(where: { string.hasPrefix($0.rawValue) }) {
+                comparison = match
+                string = String(string.dropFirst(match.rawValue.count)).trimmingCharacters(in: .whitespaces)
+            }
+            else if string.hasPrefix("=") {
+                comparison = .equal
+                string = String(string.dropFirst()).trimmingCharacters(in: .whitespaces)
+            }
+            
+            guard let count = Int(string), count >= 0, comparison != .multiple || count > 0 else {
+                return nil
+            }
+            self.comparison = comparison
+            self.count = count
+        }
+        
+        /// The number of initial hits LLDB can skip without invoking the handler.
+        var ignoreCount: Int {
+            switch comparison {
+            case .greaterThanOrEqual:
+                return max(0, count - 1)
+            case .greaterThan:
+                return count
+            case .equal:
+                return max(0, count - 1)
+            case .lessThanOrEqual, .lessThan, .multiple:
+                return 0
+            }
+        }
+        
+        /// Whether the handler must count hits itself, because LLDB's ignore count cannot express the condition.
+        var requiresCounting: Bool {
+            return comparison != .greaterThanOrEqual && comparison != .greaterThan
+        }
+        
+        func isSatisfied(byHit hit: Int) -> Bool {
+            switch comparison {
+            case .equal:
+                return hit == count
+            case .greaterThanOrEqual:
+                return hit >= count
+            case .lessThanOrEqual:
+                return hit <= count
+            case .greaterThan:
+                return hit > count
+            case .lessThan:
+                return hit < count
+            case .multiple:
+                return hit % count == 0
+            }
+        }
+    }
+    
+    /// A log message template, in which `{expression}` is replaced by the expression's value.
+    /// A backslash escapes the character after it, so `\{` is a literal brace.
+    struct LogMessage: Equatable {
+        enum Segment: Equatable {
+            case literal(String)
+            case expression(String)
+        }
+        
+        var segments: [Segment]
+        
+        init(_ template: String) {
+            var segments: [Segment] = []
+            var text = ""
+            var isInExpression = false
+            var isEscaped = false
+            
+            for character in template {
+                if isEscaped {
+                    switch character {
+                    case "n":
+                        text.append("\n")
+                    case "t":
+                        text.append("\t")
+                    default:
+                        text.append(character)
+                    }
+                    isEscaped = false
+                }
+                else if character == "\\" {
+                    isEscaped = true
+                }
+                else if !isInExpression && character == "{" {
+                    if !text.isEmpty {
+                        segments.append(.literal(text))
+                        text = ""
+                    }
+                    isInExpression = true
+                }
+                else if isInExpression && character == "}" {
+                    let expression = text.trimmingCharacters(in: .whitespaces)
+                    segments.append(expression.isEmpty ? .literal("{}") : .expression(expression))
+                    text = ""
+                    isInExpression = false
+                }
+                else {
+                    text.append(character)
+                }
+            }
+            
+            if isInExpression {
+                // An unterminated expression is kept as written.
+                text = "{" + text
+            }
+            if !text.isEmpty {
+                segments.append(.literal(text))
+            }
+            self.segments = segments
+        }
+        
+        func format(in frame: Frame?) -> String {
+            var output = ""
+            for segment in segments {
+                switch segment {
+                case let .literal(text):
+                    output.append(text)
+                case let .expression(expression):
+                    output.append(Self.description(of: expression, in: frame))
+                }
+            }
+            return output
+        }
+        
+        /// Reads variable paths directly, and only runs the expression parser for anything else.
+        private static func description(of expression: String, in frame: Frame?) -> String {
+            guard let frame else {
+                return "<no frame>"
+            }
+            
+            let value: Value
+            if let pathValue = frame.findValue(forVariablePath: expression), pathValue.error == nil {
+                value = pathValue
+            }
+            else {
+                do {
+                    value = try frame.evaluate(expression: expression)
+                }
+                catch {
+                    return "<\(error.localizedDescription)>"
+                }
+            }
+            
+            return value.summary ?? value.value ?? value.error.map { "<\($0)>" } ?? ""
+        }
+    }
+    
+    struct Statistics: Sendable {
+        /// Hits that reached the handler, after LLDB applied the ignore count.
+        var hitCount = 0
+        
+        /// Hits for which the condition held, or all hits if there is no condition.
+        var conditionPassCount = 0
+        
+        /// Hits for which the condition could not be checked natively and was evaluated by LLDB.
+        var conditionFallbackCount = 0
+        
+        /// Hits for which the breakpoint stopped or logged.
+        var triggerCount = 0
+        
+        /// Time spent handling each hit, including checking the condition and formatting the log message.
+        var overhead = LatencyHistogram()
+    }
+    
+    let condition: BreakpointCondition?
+    let hitCondition: HitCondition?
+    let logMessage: LogMessage?
+    
+    private let output: (String) -> Void
+    private let state = Locked(Statistics())
+    
+    private(set) lazy var callback = Breakpoint.Callback { [unowned self] _, thread, _ in
+        self.handleHit(on: thread)
+    }
+    
+    /// Creates a handler for a breakpoint's options, returning `nil` if there is nothing for the adapter to do.
+    /// `output` is invoked with each formatted log message, on LLDB's private state thread.
+    init?(condition: BreakpointCondition?, hitCondition: HitCondition?, logMessage: LogMessage?, output: @escaping (String) -> Void) {
+        guard condition != nil || logMessage != nil || hitCondition?.requiresCounting == true else {
+            return nil
+        }
+        self.condition = condition
+        self.hitCondition = hitCondition
+        self.logMessage = logMessage
+        self.output = output
+    }
+    
+    /// The ignore count to give LLDB.
+    ///
+    /// Hits that fail the condition must not count towards the hit condition, so when the handler checks
+    /// the condition itself it also counts every hit.
+    var ignoreCount: Int {
+        return condition == nil ? hitCondition?.ignoreCount ?? 0 : 0
+    }
+    
+    var statistics: Statistics {
+        return state.withLock { $0 }
+    }
+    
+    private func handleHit(on thread: SwiftLLDB.Thread) -> Bool {
+        let start = ContinuousClock.now
+        let frame = thread.frame(at: 0)
+        
+        var isFallback = false
+        if let condition {
+            var passes = frame.flatMap { condition.evaluate(in: $0) }
+            if passes == nil {
+                isFallback = true
+                passes = Self.evaluateWithLLDB(condition.expression, in: frame)
+            }
+            
+            if passes == false {
+                let duration = start.duration(to: .now)
+                state.withLock { statistics in
+                    statistics.hitCount += 1
+                    statistics.conditionFallbackCount += isFallback ? 1 : 0
+                    statistics.overhead.record(duration)
+                }
+                return false
+            }
+        }
+        
+        // The count starts from the hits LLDB skipped, so that conditions compare against the real hit number.
+        let hit = state.withLock { statistics in
+            statistics.hitCount += 1
+            statistics.conditionPassCount += 1
+            statistics.conditionFallbackCount += isFallback ? 1 : 0
+            return statistics.conditionPassCount + ignoreCount
+        }
+        
+        let isTriggered = hitCondition?.isSatisfied(byHit: hit) ?? true
+        if isTriggered, let logMessage {
+            output(logMessage.format(in: frame) + "\n")
+        }
+        
+        let duration = start.duration(to: .now)
+        state.withLock { statistics in
+            if isTriggered {
+                statistics.triggerCount += 1
+            }
+            statistics.overhead.record(duration)
+        }
+        
+        // Logpoints never stop.
+        return isTriggered && logMessage == nil
+    }
+    
+    /// Evaluates a condition as LLDB would. A condition that fails to evaluate stops, so the error can be seen.
+    private static func evaluateWithLLDB(_ expression: String, in frame: Frame?) -> Bool {
+        guard let frame, let value = try? frame.evaluate(expression: expression), let result = try? value.valueAsUnsigned() else {
+            return true
+        }
+        return result != 0
+    }
+}
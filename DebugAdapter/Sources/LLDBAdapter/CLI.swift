@@ -1,4 +1,5 @@
 import ArgumentParser
+import Foundation
 import SwiftLLDB
 
 @main
@@ -6,6 +7,8 @@ struct DebugAdapterCommand: ParsableCommand {
     static var configuration = CommandConfiguration(commandName: "DebugAdapter", subcommands: [
         RunCommand.self,
         PlatformsCommand.self,
+        StatisticsCommand.self,
+        BenchmarkCommand.self,
     ], defaultSubcommand: RunCommand.self)
 }
 
@@ -31,3 +34,67 @@ struct PlatformsCommand: ParsableCommand {
         Debugger.terminate()
     }
 }
+
+/// Prints LLDB's statistics for a run of a program, in the same form as the `icarus/statistics` request,
+/// so that symbol loading and indexing costs can be compared between builds without a client.
+struct StatisticsCommand: ParsableCommand {
+    static var configuration = CommandConfiguration(commandName: "statistics", abstract: "Prints LLDB's target statistics for a run of a program.")
+    
+    @Option(help: "The program to run.")
+    var program: String
+    
+    @Option(help: "A breakpoint location, as “file:line”, at which to stop and report. Without one, the program runs to completion.")
+    var location: String?
+    
+    @Flag(help: "Omit the details of each module and breakpoint.")
+    var summaryOnly = false
+    
+    @Argument(help: "Arguments passed to the program.")
+    var arguments: [String] = []
+    
+    func validate() throws {
+        if let location {
+            guard let separator = location.lastIndex(of: ":"), Int(location[location.index(after: separator)...]) != nil else {
+                throw ValidationError("The location “\(location)” is not of the form “file:line”.")
+            }
+        }
+    }
+    
+    func run() throws {
+        try Debugger.initialize()
+        defer {
+            Debugger.terminate()
+        }
+        
+        let debugger = Debugger()
+        debugger.isAsynchronous = false
+        
+        let target = try debugger.createTarget(path: program)
+        if let location, let separator = location.lastIndex(of: ":") {
+            _ = target.createBreakpoint(path: String(location[..<separator]), line: Int(location[location.index(after: separator)...])!)
+        }
+        
+        var options = Target.LaunchOptions()
+        options.arguments = arguments
+        
+        let process = try target.launch(with: options)
+        if location == nil {
+            while process.state == .stopped {
+                try process.resume()
+            }
+        }
+        
+        guard let json = target.statistics(summaryOnly: summaryOnly)?.jsonString else {
+            throw ValidationError("LLDB did not report statistics for the target.")
+        }
+        
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys, .withoutEscapingSlashes]
+        let statistics = try JSONDecoder().decode(JSONValue.self, from: Data(json.utf8))
+        print(String(decoding: try encoder.encode(statistics), as: UTF8.self))
+        
+        if process.state == .stopped {
+            try process.kill()
+        }
+    }
+}
@@ -25,8 +25,28 @@ public final class DebugAdapterConnection {
         /// Invoked to handle events.
         public var eventHandler: DebugAdapterEventHandler?
         
+        /// Invoked on the connection's internal queue after a response to an incoming request is written.
+        public var responseMetricsHandler: ((ResponseMetrics) -> Void)?
+        
         public init() {}
     }
+    
+    /// Measurements of an incoming request and the response to it.
+    public struct ResponseMetrics: Sendable {
+        public var command: String
+        
+        /// The time from the request being read to its response being written.
+        public var duration: Duration
+        
+        /// The length in bytes of the request's content.
+        public var requestLength: Int
+        
+        /// The length in bytes of the response, including its header.
+        public var responseLength: Int
+        
+        public var isSuccess: Bool
+    }
+    
     public private(set) var configuration = Configuration()
     
     private static let queueSpecific = DispatchSpecificKey<DebugAdapterConnection>()
@@ -98,6 +118,17 @@ public final class DebugAdapterConnection {
         start(replyOn: nil, reply: { _ in })
     }
     
+    /// Blocks until every message sent before this call has been written by the transport.
+    public func flush() {
+        guard DispatchQueue.getSpecific(key: Self.queueSpecific) !== self else {
+            transport.flush()
+            return
+        }
+        queue.sync {
+            transport.flush()
+        }
+    }
+    
     /// Stops the connection, which also stops the transport.
     /// If any requests are outstanding they are cancelled by throwing a cancellation error.
     /// If the connection is not running, this method does nothing.
@@ -187,104 +218,67 @@ public final class DebugAdapterConnection {
             guard let self else {
                 return
             }
-            self.inputDataBuffer.append(data)
-            self.readMessage()
+            self.readMessages(from: data)
         }
     }
     
-    private enum Message: Codable {
+    private enum Message {
         case request(Int, String)
         case response(Int, Int, String, Bool, String?)
         case event(Int, String)
         
-        enum CodingKeys: String, CodingKey {
-            case seq
-            case type
-            case command
-            case event
-            case requestSeq = "request_seq"
-            case success
-            case message
-        }
-        
-        init(from decoder: Decoder) throws {
-            let container = try decoder.container(keyedBy: CodingKeys.self)
+        init(envelope: DebugAdapterMessageEnvelope) throws {
+            func required<T>(_ value: T?, _ key: String) throws -> T {
+                guard let value else {
+                    throw DecodingError.keyNotFound(AnyCodingKey(key), .init(codingPath: [], debugDescription: "Message is missing required key “\(key)”."))
+                }
+                return value
+            }
             
-            let type = try container.decode(String.self, forKey: .type)
+            let type = try required(envelope.type, "type")
             switch type {
             case "request":
-                let seq = try container.decode(Int.self, forKey: .seq)
-                let command = try container.decode(String.self, forKey: .command)
-                self = .request(seq, command)
+                self = .request(try required(envelope.seq, "seq"), try required(envelope.command, "command"))
                 
             case "response":
-                let seq = try container.decode(Int.self, forKey: .seq)
-                let requestSeq = try container.decode(Int.self, forKey: .requestSeq)
-                let command = try container.decode(String.self, forKey: .command)
-                let success = try container.decode(Bool.self, forKey: .success)
-                let message = try container.decodeIfPresent(String.self, forKey: .message)
-                self = .response(seq, requestSeq, command, success, message)
+                self = .response(try required(envelope.seq, "seq"), try required(envelope.requestSeq, "request_seq"), try required(envelope.command, "command"), try required(envelope.success, "success"), envelope.message)
                 
             case "event":
-                let seq = try container.decode(Int.self, forKey: .seq)
-                let event = try container.decode(String.self, forKey: .event)
-                self = .event(seq, event)
+                self = .event(try required(envelope.seq, "seq"), try required(envelope.event, "event"))
                 
             default:
-                throw DecodingError.dataCorruptedError(forKey: CodingKeys.type, in: container, debugDescription: "Unsupported message type \(type)")
-            }
-        }
-        
-        func encode(to encoder: Encoder) throws {
-            var container = encoder.container(keyedBy: CodingKeys.self)
-            
-            switch self {
-            case let .request(seq, command):
-                try container.encode(seq, forKey: .seq)
-                try container.encode("request", forKey: .type)
-                try container.encode(command, forKey: .command)
-                
-            case let .response(seq, requestSeq, command, success, message):
-                try container.encode(seq, forKey: .seq)
-                try container.encode("response", forKey: .type)
-                try container.encode(requestSeq, forKey: .requestSeq)
-                try container.encode(command, forKey: .command)
-                try container.encode(success, forKey: .success)
-                try container.encode(message, forKey: .message)
-                
-            case let .event(seq, event):
-                try container.encode(seq, forKey: .seq)
-                try container.encode("event", forKey: .type)
-                try container.encode(event, forKey: .event)
+                throw DecodingError.dataCorrupted(.init(codingPath: [AnyCodingKey("type")], debugDescription: "Unsupported message type \(type)"))
             }
         }
     }
     
-    private static let CRLF = Data(bytes: [0x0D, 0x0A] as [UInt8], count: 2)
-    
-    private static func data<Message>(forMessage message: Message) throws -> Data where Message: Encodable {
-        var data = Data()
-        
-        let CRLF = CRLF
+    private struct AnyCodingKey: CodingKey {
+        let stringValue: String
+        let intValue: Int? = nil
         
-        let content = try JSONEncoder().encode(message)
+        init(_ stringValue: String) {
+            self.stringValue = stringValue
+        }
         
-        let headers: [String: String] = [
-            "Content-Length": "\(content.count)"
-        ]
+        init?(stringValue: String) {
+            self.stringValue = stringValue
+        }
         
-        // Headers
-        headers.forEach { key, value in
-            let string = "\(key): \(value)"
-            if let val = string.data(using: .utf8) {
-                data.append(val)
-                data.append(CRLF)
-            }
+        init?(intValue: Int) {
+            return nil
         }
+    }
+    
+    /// Used only on the connection's queue.
+    private let messageEncoder = JSONEncoder()
+    
+    private func data<Message>(forMessage message: Message) throws -> Data where Message: Encodable {
+        let content = try messageEncoder.encode(message)
+        let header = "Content-Length: \(content.count)\r\n\r\n".utf8
         
-        data.append(CRLF)
+        var data = Data(capacity: header.count + content.count)
+        data.append(contentsOf: header)
         data.append(content)
-        
         return data
     }
     
@@ -830,27 +824,40 @@ public final class DebugAdapterConnection {
         transport.readData(minimumIncompleteLength: 0)
     }
     
-    private var inputDataBuffer = Data()
-    private var inputDataOffset = 0
-    private static let inputDataMaxOffset = 102400 // 100 KB
+    private var messageFramer = DebugAdapterMessageFramer()
     
-    private func readMessage() {
-        let data = inputDataBuffer.subdata(in: inputDataOffset ..< inputDataBuffer.count)
-        var consumedLength = 0
-        var additionalRequiredLength = 0
-        if readMessage(withData: data, consumedLength: &consumedLength, additionalRequiredLength: &additionalRequiredLength) {
-            inputDataOffset += consumedLength
-            
-            if (inputDataOffset >= Self.inputDataMaxOffset) {
-                // Reset the data buffer
-                inputDataBuffer.removeSubrange(0 ..< inputDataOffset)
-                inputDataOffset = 0
+    /// Tokens for incoming requests which have not been replied to, keyed by request sequence number.
+    private var incomingRequestTokens: [Int: CancellationToken] = [:]
+    
+    /// When each incoming request which has not been replied to was read, and its length.
+    private var incomingRequestStarts: [Int: (readAt: ContinuousClock.Instant, length: Int)] = [:]
+    
+    private func recordResponse(toRequestID requestID: Int, command: String, length: Int, isSuccess: Bool) {
+        guard let start = incomingRequestStarts.removeValue(forKey: requestID) else {
+            return
+        }
+        let metrics = ResponseMetrics(command: command, duration: start.readAt.duration(to: .now), requestLength: start.length, responseLength: length, isSuccess: isSuccess)
+        configuration.responseMetricsHandler?(metrics)
+    }
+    
+    /// Forgets the token of a request being replied to, returning whether the request was cancelled.
+    private func finishIncomingRequest(_ requestID: Int) -> Bool {
+        return incomingRequestTokens.removeValue(forKey: requestID)?.isCancelled ?? false
+    }
+    
+    private func readMessages(from data: Data) {
+        do {
+            try messageFramer.append(data) { contentData in
+                handleMessage(withContentData: contentData)
             }
-            
-            // Attempt to read the next message (if any)
-            readMessage()
         }
-        else if additionalRequiredLength > 0 {
+        catch {
+            configuration.loggingHandler?("DebugAdapter could not read message: \(error)")
+            messageFramer.reset()
+        }
+        
+        let additionalRequiredLength = messageFramer.additionalRequiredLength
+        if additionalRequiredLength > 0 {
             transport.readData(minimumIncompleteLength: additionalRequiredLength)
         }
         else {
@@ -858,70 +865,27 @@ public final class DebugAdapterConnection {
         }
     }
     
-    private func readMessage(withData data: Data, consumedLength: inout Int, additionalRequiredLength: inout Int) -> Bool {
-        // Parse Headers
-        var headers: [String:String] = [:]
-        var contentStartIdx = 0
-        
-        let CRLF = Self.CRLF
-        
-        var CRLFRange: Range<Int>?
-        var searchRange = contentStartIdx ..< data.count
-        repeat {
-            CRLFRange = data.range(of: CRLF, options: [], in: searchRange)
-            if let CRLFRange {
-                let headerDataRange = searchRange.lowerBound ..< CRLFRange.lowerBound
-                if headerDataRange.count == 0 {
-                    // End of headers
-                    contentStartIdx = CRLFRange.upperBound
-                    break
-                }
-                else {
-                    // Header
-                    let headerData = data[headerDataRange]
-                    if let headerString = String(data: headerData, encoding: .utf8),
-                       let separatorRange = headerString.range(of: ": ") {
-                        let headerName = headerString[headerString.startIndex ..< separatorRange.lowerBound]
-                        let headerValue = headerString[separatorRange.upperBound ..< headerString.endIndex]
-                        headers[String(headerName)] = String(headerValue)
-                    }
-                }
-                
-                searchRange = CRLFRange.upperBound ..< data.count
-            }
-            else {
-                // Reached end of buffer before headers ended; Not enough data received
-                consumedLength = 0
-                additionalRequiredLength = 0
-                return false
-            }
-        } while CRLFRange != nil
-        
-        // Content Length
-        let contentLengthHeader = headers["Content-Length"]
-        let contentLength = contentLengthHeader != nil ? Int(contentLengthHeader!) ?? 0 : 0
-        
-        if contentStartIdx + contentLength > data.count {
-            // Not enough data received yet
-            consumedLength = 0
-            additionalRequiredLength = (contentStartIdx + contentLength) - data.count
-            return false
-        }
-        
-        additionalRequiredLength = 0
-        consumedLength = contentStartIdx + contentLength
-        
-        // Content
-        let contentData = data[contentStartIdx ..< contentStartIdx + contentLength]
-        
+    private func handleMessage(withContentData contentData: Data) {
         do {
-            let decoder = JSONDecoder()
-            let msg = try decoder.decode(Message.self, from: contentData)
+            let envelope = try DebugAdapterMessageEnvelope(scanning: contentData)
+            let msg = try Message(envelope: envelope)
             
             let configuration = configuration
             
             switch msg {
+            case let .request(seq, command) where command == CancelRequest.command:
+                let arguments = try envelope.payloadRange.map { try JSONDecoder().decode(CancelRequest.self, from: contentData[$0]) }
+                if let requestID = arguments?.requestId, let token = incomingRequestTokens[requestID] {
+                    configuration.loggingHandler?("Received DebugAdapter cancellation of request: \(requestID)")
+                    token.cancel()
+                }
+                self.send(responseToRequestID: seq, command: command, result: nil as EmptyCodable?)
+                
             case let .request(seq, command):
+                let cancellationToken = CancellationToken(connection: self)
+                incomingRequestTokens[seq] = cancellationToken
+                incomingRequestStarts[seq] = (.now, contentData.count)
+                
                 if let handler = configuration.requestHandler {
                     self.performOnMessageQueue { [weak self] in
                         guard let self, self.isRunning else {
@@ -937,7 +901,7 @@ public final class DebugAdapterConnection {
                             }
                         }())
                         
-                        let request = IncomingRequest(connection: self, command: command, seq: seq, data: contentData)
+                        let request = IncomingRequest(connection: self, command: command, seq: seq, data: contentData, argumentsRange: envelope.payloadRange, cancellationToken: cancellationToken)
                         handler.handleRequest(request)
                     }
                 }
@@ -990,7 +954,7 @@ public final class DebugAdapterConnection {
                             }
                         }())
                         
-                        let event = IncomingEvent(connection: self, event: eventName, data: contentData)
+                        let event = IncomingEvent(connection: self, event: eventName, data: contentData, bodyRange: envelope.payloadRange)
                         handler.handleEvent(event)
                     }
                 }
@@ -1011,10 +975,8 @@ public final class DebugAdapterConnection {
             }
         }
         catch {
-            configuration.loggingHandler?("DebugAdapter could not decode message: \(error), \(String(data: data, encoding: .utf8) ?? "(nil)")")
+            configuration.loggingHandler?("DebugAdapter could not decode message: \(error), \(String(data: contentData, encoding: .utf8) ?? "(nil)")")
         }
-        
-        return true
     }
     
     public struct IncomingRequest {
@@ -1022,12 +984,32 @@ public final class DebugAdapterConnection {
         public let command: String
         private let seq: Int
         private let data: Data
+        private let argumentsRange: Range<Data.Index>?
         
-        fileprivate init(connection: DebugAdapterConnection, command: String, seq: Int, data: Data) {
+        /// Cancelled when the client sends a `cancel` request for this request.
+        /// Once cancelled, replying sends a `cancelled` error response in place of any result.
+        public let cancellationToken: CancellationToken
+        
+        fileprivate init(connection: DebugAdapterConnection, command: String, seq: Int, data: Data, argumentsRange: Range<Data.Index>?, cancellationToken: CancellationToken) {
             self.connection = connection
             self.command = command
             self.seq = seq
             self.data = data
+            self.argumentsRange = argumentsRange
+            self.cancellationToken = cancellationToken
+        }
+        
+        /// Decodes only the request's `arguments`, which were located when the message was received.
+        fileprivate func decodeArguments<Arguments: Decodable>(_ argumentsType: Arguments.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> Arguments? {
+            guard let argumentsRange else {
+                return nil
+            }
+            
+            let decoder = JSONDecoder()
+            if let userInfo {
+                decoder.userInfo = userInfo
+            }
+            return try decoder.decode(Arguments.self, from: data[argumentsRange])
         }
     }
     
@@ -1035,11 +1017,26 @@ public final class DebugAdapterConnection {
         public let connection: DebugAdapterConnection
         public let event: String
         private let data: Data
+        private let bodyRange: Range<Data.Index>?
         
-        fileprivate init(connection: DebugAdapterConnection, event: String, data: Data) {
+        fileprivate init(connection: DebugAdapterConnection, event: String, data: Data, bodyRange: Range<Data.Index>?) {
             self.connection = connection
             self.event = event
             self.data = data
+            self.bodyRange = bodyRange
+        }
+        
+        /// Decodes only the event's `body`, which was located when the message was received.
+        fileprivate func decodeBody<Body: Decodable>(_ bodyType: Body.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> Body? {
+            guard let bodyRange else {
+                return nil
+            }
+            
+            let decoder = JSONDecoder()
+            if let userInfo {
+                decoder.userInfo = userInfo
+            }
+            return try decoder.decode(Body.self, from: data[bodyRange])
         }
     }
     
@@ -1049,12 +1046,18 @@ public final class DebugAdapterConnection {
                 return
             }
             
+            if self.finishIncomingRequest(requestID) {
+                self.send(responseToRequestID: requestID, command: Request.command, error: ResponseError.cancelled)
+                return
+            }
+            
             do {
                 let responseID = self.nextMessageID()
                 let response = ResponseRequiredResultMessage<Request.Result>.success(seq: responseID, requestSeq: requestID, command: Request.command, result: result)
                 
-                let data = try Self.data(forMessage: response)
+                let data = try self.data(forMessage: response)
                 try self.transport.write(data: data)
+                self.recordResponse(toRequestID: requestID, command: Request.command, length: data.count, isSuccess: true)
             }
             catch {
                 self.send(responseToRequestID: requestID, command: Request.command, error: error)
@@ -1068,12 +1071,18 @@ public final class DebugAdapterConnection {
                 return
             }
             
+            if self.finishIncomingRequest(requestID) {
+                self.send(responseToRequestID: requestID, command: Request.command, error: ResponseError.cancelled)
+                return
+            }
+            
             do {
                 let responseID = self.nextMessageID()
                 let response = ResponseOptionalResultMessage<Request.Result>.success(seq: responseID, requestSeq: requestID, command: Request.command, result: result)
                 
-                let data = try Self.data(forMessage: response)
+                let data = try self.data(forMessage: response)
                 try self.transport.write(data: data)
+                self.recordResponse(toRequestID: requestID, command: Request.command, length: data.count, isSuccess: true)
             }
             catch {
                 self.send(responseToRequestID: requestID, command: Request.command, error: error)
@@ -1087,12 +1096,18 @@ public final class DebugAdapterConnection {
                 return
             }
             
+            if self.finishIncomingRequest(requestID) {
+                self.send(responseToRequestID: requestID, command: Request.command, error: ResponseError.cancelled)
+                return
+            }
+            
             do {
                 let responseID = self.nextMessageID()
                 let response = ResponseVoidMessage.success(seq: responseID, requestSeq: requestID, command: Request.command)
                 
-                let data = try Self.data(forMessage: response)
+                let data = try self.data(forMessage: response)
                 try self.transport.write(data: data)
+                self.recordResponse(toRequestID: requestID, command: Request.command, length: data.count, isSuccess: true)
             }
             catch {
                 self.send(responseToRequestID: requestID, command: Request.command, error: error)
@@ -1106,12 +1121,18 @@ public final class DebugAdapterConnection {
                 return
             }
             
+            if self.finishIncomingRequest(requestID) {
+                self.send(responseToRequestID: requestID, command: command, error: ResponseError.cancelled)
+                return
+            }
+            
             do {
                 let responseID = self.nextMessageID()
                 let response = RawResponseMessage.success(seq: responseID, requestSeq: requestID, command: command, result: result)
                 
-                let data = try Self.data(forMessage: response)
+                let data = try self.data(forMessage: response)
                 try self.transport.write(data: data)
+                self.recordResponse(toRequestID: requestID, command: command, length: data.count, isSuccess: true)
             }
             catch {
                 self.send(responseToRequestID: requestID, command: command, error: error)
@@ -1125,21 +1146,27 @@ public final class DebugAdapterConnection {
                 return
             }
             
-            let message: String
-            if let error = error as? LocalizedError {
-                message = error.errorDescription ?? String(describing: error)
+            let error = self.finishIncomingRequest(requestID) ? ResponseError.cancelled : error
+            
+            let responseError: ResponseError
+            if let error = error as? ResponseError, error.message == .cancelled {
+                // Clients recognize cancellation by this exact message.
+                responseError = error
+            }
+            else if let error = error as? LocalizedError {
+                responseError = ResponseError(message: error.errorDescription ?? String(describing: error))
             }
             else {
-                message = String(describing: error)
+                responseError = ResponseError(message: String(describing: error))
             }
             
             let responseID = self.nextMessageID()
-            let responseError = ResponseError(message: message)
             let response = RawResponseMessage<EmptyCodable>.failure(seq: responseID, requestSeq: requestID, command: command, error: responseError)
             
             do {
-                let data = try Self.data(forMessage: response)
+                let data = try self.data(forMessage: response)
                 try self.transport.write(data: data)
+                self.recordResponse(toRequestID: requestID, command: command, length: data.count, isSuccess: false)
             }
             catch {
                 if let loggingHandler = self.configuration.loggingHandler {
@@ -1174,8 +1201,9 @@ public final class DebugAdapterConnection {
         supportsCancelRequest = flag
     }
     
-    public final class CancellationToken {
-        fileprivate private(set) var isCancelled = false
+    public final class CancellationToken: @unchecked Sendable {
+        private let lock = NSLock()
+        private var _isCancelled = false
         private weak var connection: DebugAdapterConnection?
         private var cancelHandlers: [() -> Void] = []
         
@@ -1183,9 +1211,27 @@ public final class DebugAdapterConnection {
             self.connection = connection
         }
         
-        fileprivate func onCancel(_ block: @escaping () -> Void) {
+        /// Whether the token has been cancelled. May be read from any thread.
+        public var isCancelled: Bool {
+            lock.lock()
+            defer { lock.unlock() }
+            return _isCancelled
+        }
+        
+        /// Registers a block invoked on the connection's queue when the token is cancelled,
+        /// or immediately if it already has been.
+        public func onCancel(_ block: @escaping () -> Void) {
             connection?.perform { [weak self] in
-                self?.cancelHandlers.append(block)
+                guard let self else {
+                    return
+                }
+                
+                if self.isCancelled {
+                    block()
+                }
+                else {
+                    self.cancelHandlers.append(block)
+                }
             }
         }
         
@@ -1195,7 +1241,9 @@ public final class DebugAdapterConnection {
                     return
                 }
                 
-                self.isCancelled = true
+                self.lock.lock()
+                self._isCancelled = true
+                self.lock.unlock()
                 
                 let handlers = self.cancelHandlers
                 self.cancelHandlers = []
@@ -1284,7 +1332,7 @@ public final class DebugAdapterConnection {
             
             let message = RequestMessage(seq: messageID, request: request)
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1365,7 +1413,7 @@ public final class DebugAdapterConnection {
             
             let message = RequestMessage(seq: messageID, request: request)
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1446,7 +1494,7 @@ public final class DebugAdapterConnection {
             
             let message = RequestMessage(seq: messageID, request: request)
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1527,7 +1575,7 @@ public final class DebugAdapterConnection {
             
             let message = RawRequestMessage(seq: messageID, command: command, arguments: arguments)
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1575,7 +1623,7 @@ public final class DebugAdapterConnection {
             let message = EventMessage<Event>(seq: eventID, event: event)
             
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1605,7 +1653,7 @@ public final class DebugAdapterConnection {
             let message = RawEventMessage(seq: eventID, event: event, body: body)
             
             do {
-                let data = try Self.data(forMessage: message)
+                let data = try self.data(forMessage: message)
                 
                 self.configuration.loggingHandler?({
                     if let prettyString = Self.prettyPrintedString(for: message) {
@@ -1629,20 +1677,15 @@ extension DebugAdapterConnection.IncomingRequest {
     /// Decodes a request of the specified type from the provided data, returning the request and a reply handler
     /// which should be invoked when handling of the request completes.
     public func decodeForReply<Request: DebugAdapterRequestWithRequiredResult>(_ requestType: Request.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> (Request, (Result<Request.Result, Error>) -> Void) {
-        let decoder = JSONDecoder()
-        if let userInfo {
-            decoder.userInfo = userInfo
-        }
-        
-        let message = try decoder.decode(DebugAdapterConnection.RequestMessage<Request>.self, from: data)
-        let request = try message.arguments ?? Request.init()
+        let request = try decodeArguments(Request.self, userInfo: userInfo) ?? Request.init()
+        let seq = seq
         
         let responseHandler: (Result<Request.Result, Error>) -> Void = { [weak connection] result in
             switch result {
             case let .success(result):
-                connection?.send(responseTo: request, requestID: message.seq, result: result)
+                connection?.send(responseTo: request, requestID: seq, result: result)
             case let .failure(error):
-                connection?.send(responseToRequestID: message.seq, command: Request.command, error: error)
+                connection?.send(responseToRequestID: seq, command: Request.command, error: error)
             }
         }
         return (request, responseHandler)
@@ -1651,20 +1694,15 @@ extension DebugAdapterConnection.IncomingRequest {
     /// Decodes a request of the specified type from the provided data, returning the request and a reply handler
     /// which should be invoked when handling of the request completes.
     public func decodeForReply<Request: DebugAdapterRequestWithOptionalResult>(_ requestType: Request.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> (Request, (Result<Request.Result?, Error>) -> Void) {
-        let decoder = JSONDecoder()
-        if let userInfo {
-            decoder.userInfo = userInfo
-        }
-        
-        let message = try decoder.decode(DebugAdapterConnection.RequestMessage<Request>.self, from: data)
-        let request = try message.arguments ?? Request.init()
+        let request = try decodeArguments(Request.self, userInfo: userInfo) ?? Request.init()
+        let seq = seq
         
         let responseHandler: (Result<Request.Result?, Error>) -> Void = { [weak connection] result in
             switch result {
             case let .success(result):
-                connection?.send(responseTo: request, requestID: message.seq, result: result)
+                connection?.send(responseTo: request, requestID: seq, result: result)
             case let .failure(error):
-                connection?.send(responseToRequestID: message.seq, command: Request.command, error: error)
+                connection?.send(responseToRequestID: seq, command: Request.command, error: error)
             }
         }
         return (request, responseHandler)
@@ -1673,20 +1711,15 @@ extension DebugAdapterConnection.IncomingRequest {
     /// Decodes a request of the specified type from the provided data, returning the request and a reply handler
     /// which should be invoked when handling of the request completes.
     public func decodeForReply<Request: DebugAdapterRequest>(_ requestType: Request.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> (Request, (Result<(), Error>) -> Void) where Request.Result == Void {
-        let decoder = JSONDecoder()
-        if let userInfo {
-            decoder.userInfo = userInfo
-        }
-        
-        let message = try decoder.decode(DebugAdapterConnection.RequestMessage<Request>.self, from: data)
-        let request = try message.arguments ?? Request.init()
+        let request = try decodeArguments(Request.self, userInfo: userInfo) ?? Request.init()
+        let seq = seq
         
         let responseHandler: (Result<(), Error>) -> Void = { [weak connection] result in
             switch result {
             case .success:
-                connection?.send(responseTo: request, requestID: message.seq)
+                connection?.send(responseTo: request, requestID: seq)
             case let .failure(error):
-                connection?.send(responseToRequestID: message.seq, command: Request.command, error: error)
+                connection?.send(responseToRequestID: seq, command: Request.command, error: error)
             }
         }
         return (request, responseHandler)
@@ -1695,8 +1728,9 @@ extension DebugAdapterConnection.IncomingRequest {
     /// Decodes a raw request from the provided data, returning the request and a reply handler
     /// which should be invoked when handling of the request completes.
     public func decodeForReply<Arguments, ResultType>(_ argumentsType: Arguments.Type, resultType: ResultType.Type) throws -> (Arguments?, (Result<ResultType?, Error>) -> Void) where Arguments: Codable & Sendable, ResultType: Codable & Sendable {
-        let message = try JSONDecoder().decode(DebugAdapterConnection.RawRequestMessage<Arguments>.self, from: data)
-        let request = message.arguments
+        let request = try decodeArguments(Arguments.self)
+        let seq = seq
+        let command = command
         
         let responseHandler: (Result<ResultType?, Error>) -> Void = { [weak connection] result in
             guard let connection else {
@@ -1705,9 +1739,9 @@ extension DebugAdapterConnection.IncomingRequest {
             
             switch result {
             case let .success(result):
-                connection.send(responseToRequestID: message.seq, command: message.command, result: result)
+                connection.send(responseToRequestID: seq, command: command, result: result)
             case let .failure(error):
-                connection.send(responseToRequestID: message.seq, command: message.command, error: error)
+                connection.send(responseToRequestID: seq, command: command, error: error)
             }
         }
         return (request, responseHandler)
@@ -1721,24 +1755,12 @@ extension DebugAdapterConnection.IncomingRequest {
 extension DebugAdapterConnection.IncomingEvent {
     /// Decodes an event of the specified type from the provided data.
     public func decode<Event: DebugAdapterEvent>(_ eventType: Event.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> Event {
-        let decoder = JSONDecoder()
-        if let userInfo {
-            decoder.userInfo = userInfo
-        }
-        
-        let message = try decoder.decode(DebugAdapterConnection.EventMessage<Event>.self, from: data)
-        return try message.body ?? Event.init()
+        return try decodeBody(Event.self, userInfo: userInfo) ?? Event.init()
     }
     
     /// Decodes a raw event from the provided data.
     public func decode<Body>(_ bodyType: Body.Type, userInfo: [CodingUserInfoKey: Any]? = nil) throws -> Body? where Body: Codable & Sendable {
-        let decoder = JSONDecoder()
-        if let userInfo {
-            decoder.userInfo = userInfo
-        }
-        
-        let message = try decoder.decode(DebugAdapterConnection.RawEventMessage<Body>.self, from: data)
-        return message.body
+        return try decodeBody(Body.self, userInfo: userInfo)
     }
     
     public func reject(throwing error: Error) {
@@ -1767,6 +1789,13 @@ public protocol DebugAdapterTransport {
     
     /// Invoked to write data to the transport.
     func write(data: Data) throws
+    
+    /// Invoked to block until all data previously passed to `write(data:)` has been written.
+    func flush()
+}
+
+extension DebugAdapterTransport {
+    public func flush() {}
 }
 
 /// Provided to a transport in its `setUp()` method. Transports should invoke its methods as messages are read or if the transport terminates.
@@ -1789,10 +1818,18 @@ public final class DebugAdapterFileHandleTransport: DebugAdapterTransport {
     public let inputHandle: FileHandle
     public let outputHandle: FileHandle
     
+    private let writer: DebugAdapterMessageWriter
+    
     /// Creates a transport using specified file handles.
     public init(inputHandle: FileHandle, outputHandle: FileHandle) {
         self.inputHandle = inputHandle
         self.outputHandle = outputHandle
+        self.writer = DebugAdapterMessageWriter(fileDescriptor: outputHandle.fileDescriptor)
+    }
+    
+    /// The state of the queue of data waiting to be written to the output handle.
+    public var writeQueueStatus: DebugAdapterMessageWriter.Status {
+        return writer.currentStatus
     }
     
     /// Creates a transport using stdin / stdout.
@@ -1816,11 +1853,16 @@ public final class DebugAdapterFileHandleTransport: DebugAdapterTransport {
     
     public func tearDown() {
         inputHandle.readabilityHandler = nil
+        writer.flush()
     }
     
     public func readData(minimumIncompleteLength: Int) {}
     
     public func write(data: Data) throws {
-        try outputHandle.write(contentsOf: data)
+        try writer.enqueue(data)
+    }
+    
+    public func flush() {
+        writer.flush()
     }
 }
@@ -0,0 +1,253 @@
+import Foundation
+
+/// The top-level routing fields of a Debug Adapter Protocol message.
+///
+/// The envelope is read by a single forward scan over the message's top-level object which
+/// skips over nested values without decoding them. This lets the connection route a message
+/// and later decode only its `arguments` or `body` with the concrete type, so each message is
+/// decoded exactly once.
+struct DebugAdapterMessageEnvelope {
+    var type: String?
+    var seq: Int?
+    var command: String?
+    var event: String?
+    var requestSeq: Int?
+    var success: Bool?
+    var message: String?
+    
+    /// The range of the non-null `arguments` (requests) or `body` (responses and events) value within the scanned data.
+    var payloadRange: Range<Data.Index>?
+    
+    init(scanning data: Data) throws {
+        try data.withUnsafeBytes { buffer in
+            var scanner = Scanner(bytes: buffer)
+            try scanner.scanObject { key, scanner in
+                switch key {
+                case .type:
+                    type = try scanner.scanString(in: data)
+                case .seq:
+                    seq = try scanner.scanInteger()
+                case .command:
+                    command = try scanner.scanString(in: data)
+                case .event:
+                    event = try scanner.scanString(in: data)
+                case .requestSeq:
+                    requestSeq = try scanner.scanInteger()
+                case .success:
+                    success = try scanner.scanBool()
+                case .message:
+                    message = try scanner.scanOptionalString(in: data)
+                case .arguments, .body:
+                    let range = try scanner.skipValue()
+                    if !scanner.isNull(range) {
+                        payloadRange = data.startIndex + range.lowerBound ..< data.startIndex + range.upperBound
+                    }
+                case nil:
+                    try scanner.skipValue()
+                }
+            }
+        }
+    }
+    
+    private enum Key: String, CaseIterable {
+        case type
+        case seq
+        case command
+        case event
+        case requestSeq = "request_seq"
+        case success
+        case message
+        case arguments
+        case body
+        
+        private static let allKeys: [(bytes: [UInt8], key: Key)] = allCases.map { (Array($0.rawValue.utf8), $0) }
+        
+        init?(bytes: UnsafeRawBufferPointer) {
+            guard let match = Self.allKeys.first(where: { $0.bytes.elementsEqual(bytes) }) else {
+                return nil
+            }
+            self = match.key
+        }
+    }
+    
+    private struct Scanner {
+        let bytes: UnsafeRawBufferPointer
+        var index = 0
+        
+        init(bytes: UnsafeRawBufferPointer) {
+            self.bytes = bytes
+        }
+        
+        private func error(_ description: String) -> Error {
+            return DecodingError.dataCorrupted(.init(codingPath: [], debugDescription: "\(description) at offset \(index)."))
+        }
+        
+        private mutating func skipWhitespace() {
+            while index < bytes.count {
+                switch bytes[index] {
+                case 0x20, 0x09, 0x0A, 0x0D:
+                    index += 1
+                default:
+                    return
+                }
+            }
+        }
+        
+        private mutating func expect(_ byte: UInt8) throws {
+            skipWhitespace()
+            guard index < bytes.count, bytes[index] == byte else {
+                throw error("Expected '\(Character(Unicode.Scalar(byte)))'")
+            }
+            index += 1
+        }
+        
+        /// Scans the members of the top-level object, invoking `body` with the scanner positioned at each member's value.
+        /// The body must consume the value.
+        mutating func scanObject(_ body: (Key?, inout Scanner) throws -> Void) throws {
+            try expect(UInt8(ascii: "{"))
+            skipWhitespace()
+            if index < bytes.count, bytes[index] == UInt8(ascii: "}") {
+                index += 1
+                return
+            }
+            
+            while true {
+                skipWhitespace()
+                let (keyRange, hasEscapes) = try skipString()
+                let key = hasEscapes ? nil : Key(bytes: UnsafeRawBufferPointer(rebasing: bytes[keyRange.lowerBound + 1 ..< keyRange.upperBound - 1]))
+                try expect(UInt8(ascii: ":"))
+                skipWhitespace()
+                try body(key, &self)
+                
+                skipWhitespace()
+                guard index < bytes.count else {
+                    throw error("Unterminated object")
+                }
+                if bytes[index] == UInt8(ascii: ",") {
+                    index += 1
+                }
+                else if bytes[index] == UInt8(ascii: "}") {
+                    index += 1
+                    return
+                }
+                else {
+                    throw error("Expected ',' or '}'")
+                }
+            }
+        }
+        
+        /// Skips a string, returning its range including quotes and whether it contains escape sequences.
+        private mutating func skipString() throws -> (Range<Int>, Bool) {
+            guard index < bytes.count, bytes[index] == UInt8(ascii: "\"") else {
+                throw error("Expected string")
+            }
+            let start = index
+            var hasEscapes = false
+            index += 1
+            while index < bytes.count {
+                switch bytes[index] {
+                case UInt8(ascii: "\""):
+                    index += 1
+                    return (start ..< index, hasEscapes)
+                case UInt8(ascii: "\\"):
+                    hasEscapes = true
+                    index += 2
+                default:
+                    index += 1
+                }
+            }
+            throw error("Unterminated string")
+        }
+        
+        /// Skips any JSON value, returning its range.
+        @discardableResult
+        mutating func skipValue() throws -> Range<Int> {
+            guard index < bytes.count else {
+                throw error("Expected value")
+            }
+            
+            let start = index
+            switch bytes[index] {
+            case UInt8(ascii: "\""):
+                _ = try skipString()
+            
+            case UInt8(ascii: "{"), UInt8(ascii: "["):
+                var depth = 0
+                repeat {
+                    guard index < bytes.count else {
+                        throw error("Unterminated container")
+                    }
+                    switch bytes[index] {
+                    case UInt8(ascii: "\""):
+                        _ = try skipString()
+                        continue
+                    case UInt8(ascii: "{"), UInt8(ascii: "["):
+                        depth += 1
+                    case UInt8(ascii: "}"), UInt8(ascii: "]"):
+                        depth -= 1
+                    default:
+                        break
+                    }
+                    index += 1
+                } while depth > 0
+            
+            default:
+                // Number, boolean, or null
+                while index < bytes.count {
+                    switch bytes[index] {
+                    case UInt8(ascii: ","), UInt8(ascii: "}"), UInt8(ascii: "]"), 0x20, 0x09, 0x0A, 0x0D:
+                        return start ..< index
+                    default:
+                        index += 1
+                    }
+                }
+            }
+            return start ..< index
+        }
+        
+        func isNull(_ range: Range<Int>) -> Bool {
+            return range.count == 4 && bytes[range.lowerBound] == UInt8(ascii: "n")
+        }
+        
+        mutating func scanString(in data: Data) throws -> String {
+            let (range, hasEscapes) = try skipString()
+            if hasEscapes {
+                // Rare; let the full decoder handle escape sequences.
+                return try JSONDecoder().decode(String.self, from: data[data.startIndex + range.lowerBound ..< data.startIndex + range.upperBound])
+            }
+            return String(decoding: UnsafeRawBufferPointer(rebasing: bytes[range.lowerBound + 1 ..< range.upperBound - 1]), as: UTF8.self)
+        }
+        
+        mutating func scanOptionalString(in data: Data) throws -> String? {
+            if index < bytes.count, bytes[index] == UInt8(ascii: "n") {
+                let range = try skipValue()
+                guard isNull(range) else {
+                    throw error("Expected string or null")
+                }
+                return nil
+            }
+            return try scanString(in: data)
+        }
+        
+        mutating func scanInteger() throws -> Int {
+            let range = try skipValue()
+            let string = String(decoding: UnsafeRawBufferPointer(rebasing: bytes[range]), as: UTF8.self)
+            guard let value = Int(string) else {
+                throw error("Expected integer")
+            }
+            return value
+        }
+        
+        mutating func scanBool() throws -> Bool {
+            let range = try skipValue()
+            switch range.count {
+            case 4 where bytes[range.lowerBound] == UInt8(ascii: "t"):
+                return true
+            case 5 where bytes[range.lowerBound] == UInt8(ascii: "f"):
+                return false
+            default:
+                throw error("Expected boolean")
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+import Foundation
+
+/// Incrementally splits a Debug Adapter Protocol byte stream into message contents.
+///
+/// Each incoming chunk is scanned exactly once. Header bytes are fed through a resumable state
+/// machine, so a header split across reads is never rescanned, and message content that arrives
+/// within a single chunk is handed out as a slice of that chunk without copying. Content spanning
+/// several chunks is assembled into one buffer sized from its `Content-Length` header.
+struct DebugAdapterMessageFramer {
+    enum FramingError: LocalizedError {
+        case headerTooLong
+        case contentTooLong(Int)
+        
+        var errorDescription: String? {
+            switch self {
+            case .headerTooLong:
+                return "A message header exceeded \(DebugAdapterMessageFramer.maximumHeaderLength) bytes."
+            case let .contentTooLong(length):
+                return "A message’s Content-Length of \(length) bytes exceeded \(DebugAdapterMessageFramer.maximumContentLength) bytes."
+            }
+        }
+    }
+    
+    /// The maximum length of a single header line, after which the stream is considered malformed.
+    static let maximumHeaderLength = 1024
+    
+    /// The maximum length of a message's content, matching the writer's bound on pending output, so that a
+    /// malformed `Content-Length` cannot force a huge allocation.
+    static let maximumContentLength = 8 * 1024 * 1024
+    
+    private enum State {
+        case header
+        case content(length: Int)
+    }
+    
+    private static let CR: UInt8 = 0x0D
+    private static let LF: UInt8 = 0x0A
+    private static let contentLengthName = Array("content-length".utf8)
+    
+    private var state = State.header
+    private var headerLine: [UInt8] = []
+    private var contentLength: Int?
+    private var partialContent = Data()
+    
+    init() {
+        headerLine.reserveCapacity(64)
+    }
+    
+    /// The number of bytes still required to complete the message currently being read.
+    /// This is `0` while headers are being read, since their length is not known in advance.
+    var additionalRequiredLength: Int {
+        switch state {
+        case .header:
+            return 0
+        case let .content(length):
+            return length - partialContent.count
+        }
+    }
+    
+    /// Discards any partially read message.
+    mutating func reset() {
+        state = .header
+        headerLine.removeAll(keepingCapacity: true)
+        contentLength = nil
+        partialContent = Data()
+    }
+    
+    /// Consumes a chunk of the stream, invoking `handler` with the content of each message it completes, in order.
+    mutating func append(_ data: Data, _ handler: (Data) throws -> Void) throws {
+        var index = data.startIndex
+        let endIndex = data.endIndex
+        
+        while index < endIndex {
+            switch state {
+            case .header:
+                guard let lineEnd = data[index ..< endIndex].firstIndex(of: Self.LF) else {
+                    headerLine.append(contentsOf: data[index ..< endIndex])
+                    index = endIndex
+                    if headerLine.count > Self.maximumHeaderLength {
+                        throw FramingError.headerTooLong
+                    }
+                    break
+                }
+                
+                headerLine.append(contentsOf: data[index ..< lineEnd])
+                index = lineEnd + 1
+                
+                if headerLine.last == Self.CR {
+                    headerLine.removeLast()
+                }
+                if headerLine.count > Self.maximumHeaderLength {
+                    throw FramingError.headerTooLong
+                }
+                
+                if headerLine.isEmpty {
+                    // End of headers
+                    let length = contentLength ?? 0
+                    contentLength = nil
+                    if length == 0 {
+                        try handler(Data())
+                    }
+                    else {
+                        state = .content(length: length)
+                    }
+                }
+                else {
+                    if let length = Self.contentLength(fromHeader: headerLine) {
+                        if length > Self.maximumContentLength {
+                            throw FramingError.contentTooLong(length)
+                        }
+                        contentLength = length
+                    }
+                    headerLine.removeAll(keepingCapacity: true)
+                }
+            
+            case let .content(length):
+                let availableLength = endIndex - index
+                
+                if partialContent.isEmpty && availableLength >= length {
+                    // The entire content is within this chunk
+                    let content = data[index ..< index + length]
+                    index += length
+                    state = .header
+                    try handler(content)
+                }
+                else {
+                    if partialContent.isEmpty {
+                        partialContent.reserveCapacity(length)
+                    }
+                    
+                    let chunkLength = min(length - partialContent.count, availableLength)
+                    partialContent.append(data[index ..< index + chunkLength])
+                    index += chunkLength
+                    
+                    if partialContent.count == length {
+                        let content = partialContent
+                        partialContent = Data()
+                        state = .header
+                        try handler(content)
+                    }
+                }
+            }
+        }
+    }
+    
+    /// Parses the value of a `Content-Length` header line, returning `nil` for any other header.
+    private static func contentLength(fromHeader line: [UInt8]) -> Int? {
+        guard let separatorIndex = line.firstIndex(of: UInt8(ascii: ":")),
+              separatorIndex == contentLengthName.count else {
+            return nil
+        }
+        
+        for (byte, expected) in zip(line[..<separatorIndex], contentLengthName) {
+            // ASCII lowercase
+            let lowercased = (byte >= 0x41 && byte <= 0x5A) ? byte | 0x20 : byte
+            if lowercased != expected {
+                return nil
+            }
+        }
+        
+        var length = 0
+        var hasDigits = false
+        for byte in line[(separatorIndex + 1)...] {
+            switch byte {
+            case UInt8(ascii: " "), UInt8(ascii: "\t"):
+                if hasDigits {
+                    return length
+                }
+            case UInt8(ascii: "0") ... UInt8(ascii: "9"):
+                let (multiplied, multiplyOverflow) = length.multipliedReportingOverflow(by: 10)
+                let (added, addOverflow) = multiplied.addingReportingOverflow(Int(byte - UInt8(ascii: "0")))
+                if multiplyOverflow || addOverflow {
+                    return nil
+                }
+                length = added
+                hasDigits = true
+            default:
+                return nil
+            }
+        }
+        return hasDigits ? length : nil
+    }
+}
@@ -0,0 +1,188 @@
+import Foundation
+
+/// Writes framed messages to a file descriptor from a dedicated queue.
+///
+/// Callers enqueue messages without waiting on the descriptor. Messages that accumulate while a
+/// write is in progress are written together with a single `writev(2)` call. When the bytes waiting
+/// to be written exceed `maximumPendingByteCount`, `enqueue(_:)` blocks until the reader catches up,
+/// so a stalled client slows the adapter down instead of growing memory without bound.
+public final class DebugAdapterMessageWriter: @unchecked Sendable {
+    /// A snapshot of the writer's queue.
+    public struct Status: Sendable {
+        /// Messages waiting to be written, including those in the write currently in progress.
+        public var pendingMessageCount = 0
+        
+        /// Bytes waiting to be written, including those in the write currently in progress.
+        public var pendingByteCount = 0
+        
+        /// The largest value `pendingByteCount` has reached.
+        public var peakPendingByteCount = 0
+        
+        /// The total number of messages written.
+        public var writtenMessageCount = 0
+        
+        /// The total number of write system calls made.
+        public var writeCallCount = 0
+        
+        /// The number of times `enqueue(_:)` blocked because the queue was full.
+        public var backpressureCount = 0
+    }
+    
+    let fileDescriptor: Int32
+    let maximumPendingByteCount: Int
+    
+    /// The maximum number of messages written by a single system call.
+    private static let maximumBatchCount = 64
+    
+    private let queue = DispatchQueue(label: "com.panic.debugadapter.writer", qos: .userInitiated)
+    private let condition = NSCondition()
+    private var pendingMessages: [Data] = []
+    private var status = Status()
+    private var isWriting = false
+    private var writeError: Error?
+    
+    init(fileDescriptor: Int32, maximumPendingByteCount: Int = 8 * 1024 * 1024) {
+        self.fileDescriptor = fileDescriptor
+        self.maximumPendingByteCount = maximumPendingByteCount
+    }
+    
+    var currentStatus: Status {
+        condition.lock()
+        defer { condition.unlock() }
+        return status
+    }
+    
+    /// Enqueues a message to be written, blocking while the queue is full.
+    /// Throws the error of a previously failed write, after which the writer accepts no more messages.
+    func enqueue(_ data: Data) throws {
+        guard !data.isEmpty else {
+            return
+        }
+        
+        condition.lock()
+        defer { condition.unlock() }
+        
+        // A message larger than the limit is still admitted into an empty queue.
+        if writeError == nil && status.pendingByteCount > 0 && status.pendingByteCount + data.count > maximumPendingByteCount {
+            status.backpressureCount += 1
+            repeat {
+                condition.wait()
+            } while writeError == nil && status.pendingByteCount > 0 && status.pendingByteCount + data.count > maximumPendingByteCount
+        }
+        
+        if let writeError {
+            throw writeError
+        }
+        
+        pendingMessages.append(data)
+        status.pendingMessageCount += 1
+        status.pendingByteCount += data.count
+        status.peakPendingByteCount = max(status.peakPendingByteCount, status.pendingByteCount)
+        
+        if !isWriting {
+            isWriting = true
+            queue.async { [self] in
+                drain()
+            }
+        }
+    }
+    
+    /// Blocks until every message enqueued so far has been written or the writer has failed.
+    func flush() {
+        condition.lock()
+        defer { condition.unlock() }
+        
+        while isWriting {
+            condition.wait()
+        }
+    }
+    
+    private func drain() {
+        while true {
+            condition.lock()
+            if pendingMessages.isEmpty || writeError != nil {
+                isWriting = false
+                condition.broadcast()
+                condition.unlock()
+                return
+            }
+            let batch = Array(pendingMessages.prefix(Self.maximumBatchCount))
+            pendingMessages.removeFirst(batch.count)
+            condition.unlock()
+            
+            let byteCount = batch.reduce(0) { $0 + $1.count }
+            let result = Result { try write(batch) }
+            
+            condition.lock()
+            status.pendingMessageCount -= batch.count
+            status.pendingByteCount -= byteCount
+            if case let .failure(error) = result {
+                writeError = error
+                pendingMessages.removeAll()
+                status.pendingMessageCount = 0
+                status.pendingByteCount = 0
+            }
+            else {
+                status.writtenMessageCount += batch.count
+            }
+            condition.broadcast()
+            condition.unlock()
+        }
+    }
+    
+    /// Writes every byte of the batch, resuming after partial writes.
+    private func write(_ batch: [Data]) throws {
+        var messageIndex = 0
+        var messageOffset = 0
+        
+        while messageIndex < batch.count {
+            var vectors: [iovec] = []
+            vectors.reserveCapacity(batch.count - messageIndex)
+            
+            let writtenCount = Self.withIOVectors(batch[messageIndex...], firstOffset: messageOffset, into: &vectors) { vectors in
+                vectors.withUnsafeBufferPointer { buffer in
+                    writev(fileDescriptor, buffer.baseAddress, Int32(buffer.count))
+                }
+            }
+            
+            if writtenCount < 0 {
+                if errno == EINTR || errno == EAGAIN {
+                    continue
+                }
+                throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            }
+            
+            condition.lock()
+            status.writeCallCount += 1
+            condition.unlock()
+            
+            // Advance past the bytes that were written
+            var remaining = writtenCount
+            while remaining > 0 {
+                let available = batch[messageIndex].count - messageOffset
+                if remaining >= available {
+                    remaining -= available
+                    messageIndex += 1
+                    messageOffset = 0
+                }
+                else {
+                    messageOffset += remaining
+                    remaining = 0
+                }
+            }
+        }
+    }
+    
+    /// Builds I/O vectors over the messages' storage, which is only valid for the duration of `body`.
+    private static func withIOVectors<R>(_ messages: ArraySlice<Data>, firstOffset: Int, into vectors: inout [iovec], _ body: ([iovec]) -> R) -> R {
+        guard let message = messages.first else {
+            return body(vectors)
+        }
+        
+        return message.withUnsafeBytes { buffer in
+            let bytes = UnsafeRawBufferPointer(rebasing: buffer[firstOffset...])
+            vectors.append(iovec(iov_base: UnsafeMutableRawPointer(mutating: bytes.baseAddress), iov_len: bytes.count))
+            return withIOVectors(messages.dropFirst(), firstOffset: 0, into: &vectors, body)
+        }
+    }
+}
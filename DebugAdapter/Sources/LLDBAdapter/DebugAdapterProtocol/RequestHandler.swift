@@ -26,6 +26,7 @@ public protocol DebugAdapterServerRequestHandler: DebugAdapterRequestHandler {
     func launch(_ request: DebugAdapter.LaunchRequest<LaunchParameters>, replyHandler: @escaping (Result<(), Error>) -> Void)
     func loadedSources(_ request: DebugAdapter.LoadedSourcesRequest, replyHandler: @escaping (Result<DebugAdapter.LoadedSourcesRequest.Result, Error>) -> Void)
     func locations(_ request: DebugAdapter.LocationsRequest, replyHandler: @escaping (Result<DebugAdapter.LocationsRequest.Result, Error>) -> Void)
+    func modules(_ request: DebugAdapter.ModulesRequest, replyHandler: @escaping (Result<DebugAdapter.ModulesRequest.Result, Error>) -> Void)
     func next(_ request: DebugAdapter.NextRequest, replyHandler: @escaping (Result<(), Error>) -> Void)
     func pause(_ request: DebugAdapter.PauseRequest, replyHandler: @escaping (Result<(), Error>) -> Void)
     func readMemory(_ request: DebugAdapter.ReadMemoryRequest, replyHandler: @escaping (Result<DebugAdapter.ReadMemoryRequest.Result?, Error>) -> Void)
@@ -137,6 +138,10 @@ public extension DebugAdapterServerRequestHandler {
             let (request, replyHandler) = try request.decodeForReply(DebugAdapter.LocationsRequest.self)
             locations(request, replyHandler: replyHandler)
             
+        case DebugAdapter.ModulesRequest.command:
+            let (request, replyHandler) = try request.decodeForReply(DebugAdapter.ModulesRequest.self)
+            modules(request, replyHandler: replyHandler)
+            
         case DebugAdapter.NextRequest.command:
             let (request, replyHandler) = try request.decodeForReply(DebugAdapter.NextRequest.self)
             next(request, replyHandler: replyHandler)
@@ -305,6 +310,10 @@ public extension DebugAdapterServerRequestHandler {
         replyHandler(.failure(DebugAdapterConnection.ResponseError.unsupportedRequest(request)))
     }
     
+    func modules(_ request: DebugAdapter.ModulesRequest, replyHandler: @escaping (Result<DebugAdapter.ModulesRequest.Result, Error>) -> Void) {
+        replyHandler(.failure(DebugAdapterConnection.ResponseError.unsupportedRequest(request)))
+    }
+    
     func next(_ request: DebugAdapter.NextRequest, replyHandler: @escaping (Result<(), Error>) -> Void) {
         replyHandler(.failure(DebugAdapterConnection.ResponseError.unsupportedRequest(request)))
     }
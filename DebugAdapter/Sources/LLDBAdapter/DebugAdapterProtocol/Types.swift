@@ -1125,6 +1125,25 @@ public enum DebugAdapter {
         }
     }
     
+    public struct ModulesRequest: DebugAdapterRequestWithRequiredResult {
+        public static var command: String { "modules" }
+        
+        public var startModule: Int?
+        public var moduleCount: Int?
+        
+        public struct Result: Sendable, Hashable, Codable {
+            public var modules: [Module]
+            public var totalModules: Int?
+            
+            public init(modules: [Module], totalModules: Int? = nil) {
+                self.modules = modules
+                self.totalModules = totalModules
+            }
+        }
+        
+        public init() {}
+    }
+    
     public struct NextRequest: DebugAdapterRequest {
         public static var command: String { "next" }
         
@@ -1444,12 +1463,11 @@ public enum DebugAdapter {
         
         public struct Result: Sendable, Hashable, Codable {
             public var stackFrames: [StackFrame]
-            public var totalFrames: Int {
-                return stackFrames.count
-            }
+            public var totalFrames: Int?
             
-            public init(stackFrames: [StackFrame]) {
+            public init(stackFrames: [StackFrame], totalFrames: Int? = nil) {
                 self.stackFrames = stackFrames
+                self.totalFrames = totalFrames
             }
         }
         
@@ -0,0 +1,459 @@
+import Foundation
+import SwiftLLDB
+
+/// Caches the disassembly of whole symbols, so that scrolling through a function in either direction
+/// reads and formats each instruction only once.
+///
+/// A symbol is disassembled in full the first time an address in it is requested. This is also what
+/// resolves a negative instruction offset, since instructions of variable length cannot be decoded
+/// backwards from an arbitrary address. Symbols are keyed by their module's UUID and file address
+/// range, so their disassembly is kept when the debuggee is relaunched; only the formatted text, which
+/// contains load addresses, is rebuilt if the symbol has moved.
+///
+/// The cache may be used from any lane. Its lock is held only to look up, insert and evict symbols,
+/// never while LLDB disassembles or formats instructions, so a long disassembly does not hold up
+/// invalidation or other lanes.
+final class DisassemblyCache {
+    struct Statistics: Sendable {
+        var hitCount = 0
+        var missCount = 0
+        var disassembledInstructionCount = 0
+        var disassemblyDuration: Duration = .zero
+    }
+    
+    private struct Key: Hashable {
+        var moduleID: String
+        var fileAddresses: Range<UInt64>
+    }
+    
+    /// The disassembly of one symbol.
+    private final class Block {
+        let instructions: InstructionList
+        
+        /// The offset of each instruction from the start of the symbol, in ascending order.
+        let offsets: [UInt64]
+        let size: UInt64
+        
+        /// The label shown on the symbol's first instruction, and the name reported for it.
+        let label: String
+        let symbolName: String?
+        
+        // The following are guarded by the cache's lock.
+        
+        /// The address of the symbol that `formatted` was built for.
+        var baseAddress: UInt64
+        var formatted: [DebugAdapter.DisassembledInstruction?]
+        
+        var lastUse = 0
+        
+        init(instructions: InstructionList, offsets: [UInt64], size: UInt64, label: String, symbolName: String?, baseAddress: UInt64) {
+            self.instructions = instructions
+            self.offsets = offsets
+            self.size = size
+            self.label = label
+            self.symbolName = symbolName
+            self.baseAddress = baseAddress
+            self.formatted = Array(repeating: nil, count: offsets.count)
+        }
+    }
+    
+    /// A position in the disassembly of a cached symbol, loaded at `baseAddress`.
+    private struct Cursor {
+        var block: Block
+        var baseAddress: UInt64
+        var index: Int
+        
+        var address: UInt64 {
+            return baseAddress + block.offsets[index]
+        }
+    }
+    
+    private struct State {
+        var blocks: [Key: Block] = [:]
+        
+        /// The sorted start file addresses of each module's code symbols, for finding the symbol before
+        /// one that follows padding.
+        var codeSymbolStarts: [String: [UInt64]] = [:]
+        var instructionCount = 0
+        var useCount = 0
+    }
+    
+    /// Symbols larger than this are not disassembled in full, since they are unlikely to be code.
+    static let maximumSymbolSize: UInt64 = 4 << 20
+    
+    /// The number of instructions kept before the least recently used symbols are dropped.
+    let capacity: Int
+    
+    private let state = Locked(State())
+    
+    /// Kept apart from `state`, so that reading the statistics never waits for a lookup or eviction.
+    private let statisticsSnapshot = Locked(Statistics())
+    
+    init(capacity: Int = 500_000) {
+        self.capacity = capacity
+    }
+    
+    var statistics: Statistics {
+        return statisticsSnapshot.withLock { $0 }
+    }
+    
+    /// Disassembles `count` instructions, starting `instructionOffset` instructions from the one at `address`.
+    ///
+    /// Exactly `count` instructions are returned, as the disassemble request requires. Positions that
+    /// cannot be disassembled, such as those before the first symbol that can be found, are filled with
+    /// invalid instructions.
+    func instructions(at address: UInt64, instructionOffset: Int, count: Int, in target: Target, checkCancellation: () throws -> Void) rethrows -> [DebugAdapter.DisassembledInstruction] {
+        defer {
+            evictIfNeeded()
+        }
+        
+        var result: [DebugAdapter.DisassembledInstruction] = []
+        result.reserveCapacity(count)
+        
+        guard var cursor = self.cursor(at: address, in: target) else {
+            // Outside any symbol, disassembly can only start at the address and go forwards.
+            let missing = min(max(0, -instructionOffset), count)
+            result += Self.invalidInstructions(before: address, count: missing)
+            result += try uncachedInstructions(at: address, skipping: max(0, instructionOffset), count: count - result.count, in: target, checkCancellation: checkCancellation)
+            return result
+        }
+        
+        // Move back through preceding symbols until the first instruction requested is reached.
+        var offset = instructionOffset
+        while offset < 0 {
+            if cursor.index + offset >= 0 {
+                cursor.index += offset
+                offset = 0
+            }
+            else if let previous = previousCursor(before: cursor.baseAddress, in: target) {
+                offset += cursor.index + 1
+                cursor = previous
+            }
+            else {
+                offset += cursor.index
+                cursor.index = 0
+                break
+            }
+        }
+        
+        if offset < 0 {
+            let missing = min(-offset, count)
+            result += Self.invalidInstructions(before: cursor.address, count: missing)
+            offset = 0
+        }
+        
+        // Move forwards through following symbols, skipping any remaining offset.
+        while result.count < count {
+            try checkCancellation()
+            
+            let block = cursor.block
+            if cursor.index < block.offsets.count {
+                if offset > 0 {
+                    let step = min(offset, block.offsets.count - cursor.index)
+                    cursor.index += step
+                    offset -= step
+                }
+                else {
+                    result.append(formattedInstruction(at: cursor, in: target))
+                    cursor.index += 1
+                }
+                continue
+            }
+            
+            let end = cursor.baseAddress + block.size
+            guard let next = self.cursor(at: end, in: target), next.block !== block else {
+                result += try uncachedInstructions(at: end, skipping: offset, count: count - result.count, in: target, checkCancellation: checkCancellation)
+                break
+            }
+            cursor = next
+        }
+        
+        return result
+    }
+    
+    /// Drops the disassembly of symbols that overlap memory that was written.
+    func invalidate(addresses: Range<UInt64>) {
+        state.withLock { state in
+            for (key, block) in state.blocks where block.baseAddress < addresses.upperBound && addresses.lowerBound < block.baseAddress + block.size {
+                state.blocks[key] = nil
+                state.instructionCount -= block.offsets.count
+            }
+        }
+    }
+    
+    /// Drops all disassembly, along with the instruction lists that keep their modules alive, when the
+    /// target is replaced.
+    func removeAll() {
+        state.withLock { state in
+            state.blocks.removeAll()
+            state.codeSymbolStarts.removeAll()
+            state.instructionCount = 0
+        }
+    }
+    
+    // MARK: - Symbols
+    
+    /// Finds the instruction containing `address`, disassembling its symbol if it is not cached.
+    private func cursor(at address: UInt64, in target: Target) -> Cursor? {
+        guard let resolved = Address(at: address, in: target),
+              let symbol = resolved.symbol,
+              let start = symbol.startAddress?.fileAddress,
+              let end = symbol.endAddress?.fileAddress,
+              start < end, end - start <= Self.maximumSymbolSize,
+              (start ..< end).contains(resolved.fileAddress),
+              let module = resolved.module else {
+            return nil
+        }
+        
+        let key = Key(moduleID: Self.moduleID(for: module), fileAddresses: start ..< end)
+        let relativeAddress = resolved.fileAddress - start
+        let baseAddress = address &- relativeAddress
+        
+        var block: Block? = state.withLock { state -> Block? in
+            guard let block = state.blocks[key] else {
+                return nil
+            }
+            state.useCount += 1
+            block.lastUse = state.useCount
+            
+            if block.baseAddress != baseAddress {
+                block.baseAddress = baseAddress
+                block.formatted = Array(repeating: nil, count: block.offsets.count)
+            }
+            return block
+        }
+        
+        if block != nil {
+            statisticsSnapshot.withLock { $0.hitCount += 1 }
+        }
+        else {
+            // Disassemble without the lock. If another lane cached the symbol meanwhile, its block is used.
+            let clock = ContinuousClock()
+            let startTime = clock.now
+            guard let disassembled = disassemble(symbol, baseAddress: baseAddress, in: target) else {
+                return nil
+            }
+            let duration = startTime.duration(to: clock.now)
+            
+            block = state.withLock { state -> Block in
+                state.useCount += 1
+                
+                let block = state.blocks[key] ?? disassembled
+                if block === disassembled {
+                    state.blocks[key] = block
+                    state.instructionCount += block.offsets.count
+                }
+                block.lastUse = state.useCount
+                return block
+            }
+            
+            statisticsSnapshot.withLock { statistics in
+                statistics.missCount += 1
+                statistics.disassembledInstructionCount += disassembled.offsets.count
+                statistics.disassemblyDuration += duration
+            }
+        }
+        
+        guard let block else {
+            return nil
+        }
+        return Cursor(block: block, baseAddress: baseAddress, index: Self.lastIndex(in: block.offsets, notAfter: relativeAddress) ?? 0)
+    }
+    
+    /// Finds the last instruction of the symbol before `address`, allowing for padding between the two.
+    ///
+    /// The preceding symbol is looked up in the module's symbol table, since alignment padding and runs
+    /// of stubs between functions can be of any length. Only symbols in the same section are considered.
+    private func previousCursor(before address: UInt64, in target: Target) -> Cursor? {
+        guard address > 0, let resolved = Address(at: address - 1, in: target), let module = resolved.module else {
+            return nil
+        }
+        
+        // Without padding, the byte before is the end of the preceding symbol.
+        if let cursor = self.cursor(at: address - 1, in: target) {
+            return cursor
+        }
+        
+        let fileAddress = resolved.fileAddress
+        let sectionStart = fileAddress - min(resolved.offset, fileAddress)
+        let starts = codeSymbolStarts(in: module)
+        
+        guard let index = Self.lastIndex(in: starts, notAfter: fileAddress), starts[index] >= sectionStart,
+              var cursor = self.cursor(at: (address - 1) &- (fileAddress - starts[index]), in: target) else {
+            return nil
+        }
+        cursor.index = cursor.block.offsets.count - 1
+        return cursor
+    }
+    
+    private func codeSymbolStarts(in module: Module) -> [UInt64] {
+        let moduleID = Self.moduleID(for: module)
+        if let starts = state.withLock({ $0.codeSymbolStarts[moduleID] }) {
+            return starts
+        }
+        
+        let starts = module.symbols.compactMap { $0.isCode ? $0.startAddress?.fileAddress : nil }.sorted()
+        state.withLock { $0.codeSymbolStarts[moduleID] = starts }
+        return starts
+    }
+    
+    private static func moduleID(for module: Module) -> String {
+        return module.uuid ?? module.fileSpec?.path ?? ""
+    }
+    
+    private func disassemble(_ symbol: Symbol, baseAddress: UInt64, in target: Target) -> Block? {
+        guard let instructions = symbol.instructions(in: target) else {
+            return nil
+        }
+        
+        let count = instructions.count
+        guard count > 0 else {
+            return nil
+        }
+        
+        // The symbol is disassembled contiguously, so each instruction starts where the last one ended.
+        var offsets: [UInt64] = []
+        offsets.reserveCapacity(count)
+        var offset: UInt64 = 0
+        for index in 0 ..< count {
+            offsets.append(offset)
+            offset += UInt64(instructions[index].byteSize)
+        }
+        
+        return Block(instructions: instructions, offsets: offsets, size: max(offset, symbol.size), label: symbol.mangledName ?? symbol.name ?? "", symbolName: symbol.displayName, baseAddress: baseAddress)
+    }
+    
+    private func evictIfNeeded() {
+        state.withLock { state in
+            while state.instructionCount > capacity, state.blocks.count > 1, let oldest = state.blocks.min(by: { $0.value.lastUse < $1.value.lastUse }) {
+                state.blocks[oldest.key] = nil
+                state.instructionCount -= oldest.value.offsets.count
+            }
+        }
+    }
+    
+    /// The index of the last element of `values` not after `value`, or `nil` if every element is after it.
+    private static func lastIndex(in values: [UInt64], notAfter value: UInt64) -> Int? {
+        var low = 0
+        var high = values.count
+        while low < high {
+            let mid = (low + high) / 2
+            if values[mid] <= value {
+                low = mid + 1
+            }
+            else {
+                high = mid
+            }
+        }
+        return low > 0 ? low - 1 : nil
+    }
+    
+    // MARK: - Formatting
+    
+    private func formattedInstruction(at cursor: Cursor, in target: Target) -> DebugAdapter.DisassembledInstruction {
+        let block = cursor.block
+        let cached = state.withLock { _ in
+            block.baseAddress == cursor.baseAddress ? block.formatted[cursor.index] : nil
+        }
+        if let cached {
+            return cached
+        }
+        
+        let isFirst = cursor.index == 0
+        let formatted = Self.format(block.instructions[cursor.index], at: cursor.address, label: isFirst ? block.label : nil, symbolName: isFirst ? block.symbolName : nil, in: target)
+        state.withLock { _ in
+            if block.baseAddress == cursor.baseAddress {
+                block.formatted[cursor.index] = formatted
+            }
+        }
+        return formatted
+    }
+    
+    /// Disassembles memory outside any symbol that could be found, such as JIT-compiled code.
+    private func uncachedInstructions(at address: UInt64, skipping skipped: Int, count: Int, in target: Target, checkCancellation: () throws -> Void) rethrows -> [DebugAdapter.DisassembledInstruction] {
+        var result: [DebugAdapter.DisassembledInstruction] = []
+        var end = address
+        
+        if count > 0, let start = Address(at: address, in: target), let instructions = target.readInstructions(at: start, count: skipped + count) {
+            for instruction in instructions.dropFirst(skipped) {
+                try checkCancellation()
+                
+                let instructionAddress = instruction.address
+                let loadAddress = instructionAddress?.loadAddress(for: target) ?? end
+                
+                var label: String?
+                var symbolName: String?
+                if let symbol = instructionAddress?.symbol, symbol.startAddress == instructionAddress {
+                    label = symbol.mangledName ?? symbol.name ?? ""
+                    symbolName = symbol.displayName
+                }
+                
+                result.append(Self.format(instruction, at: loadAddress, label: label, symbolName: symbolName, in: target))
+                end = loadAddress &+ UInt64(instruction.byteSize)
+            }
+        }
+        
+        return result + Self.invalidInstructions(from: end, count: count - result.count)
+    }
+    
+    private static func format(_ instruction: SwiftLLDB.Instruction, at address: UInt64, label: String?, symbolName: String?, in target: Target) -> DebugAdapter.DisassembledInstruction {
+        var text = ""
+        if let label {
+            // Prepend the symbol name to the first line.
+            text += label + ": "
+        }
+        
+        let mnemonic = instruction.mnemonic(for: target) ?? ""
+        text += padding(toWidth: 7, for: mnemonic) + mnemonic
+        
+        let operands = instruction.operands(for: target) ?? ""
+        text += padding(toWidth: 12, for: operands) + operands
+        
+        if let comment = instruction.comment(for: target), !comment.isEmpty {
+            text += " ; " + comment
+        }
+        
+        var formatted = DebugAdapter.DisassembledInstruction(address: formatAddress(address), instruction: text)
+        if let data = instruction.data(for: target) {
+            formatted.instructionBytes = hexString(data.bytes)
+        }
+        formatted.symbol = symbolName
+        return formatted
+    }
+    
+    private static func padding(toWidth width: Int, for string: String) -> String {
+        let count = string.utf8.count
+        return count < width ? String(repeating: " ", count: width - count) : ""
+    }
+    
+    private static func formatAddress(_ address: UInt64) -> String {
+        return "0x" + String(address, radix: 16)
+    }
+    
+    private static let hexDigits = Array("0123456789abcdef".utf8)
+    
+    private static func hexString(_ bytes: [UInt8]) -> String {
+        return String(unsafeUninitializedCapacity: bytes.count * 2) { buffer in
+            for (index, byte) in bytes.enumerated() {
+                buffer[index * 2] = hexDigits[Int(byte >> 4)]
+                buffer[index * 2 + 1] = hexDigits[Int(byte & 0x0f)]
+            }
+            return bytes.count * 2
+        }
+    }
+    
+    /// Placeholders for the `count` bytes before `address`, which could not be disassembled.
+    private static func invalidInstructions(before address: UInt64, count: Int) -> [DebugAdapter.DisassembledInstruction] {
+        let count = Int(min(UInt64(max(0, count)), address))
+        return invalidInstructions(from: address - UInt64(count), count: count)
+    }
+    
+    /// Placeholders for the `count` bytes from `address`, which could not be disassembled.
+    private static func invalidInstructions(from address: UInt64, count: Int) -> [DebugAdapter.DisassembledInstruction] {
+        return (0 ..< UInt64(max(0, count))).map { offset in
+            var instruction = DebugAdapter.DisassembledInstruction(address: formatAddress(address &+ offset), instruction: "??")
+            instruction.presentationHint = .invalid
+            return instruction
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/// Hands out integer handles for values the client can refer back to, such as `variablesReference`.
+///
+/// A handle names a slot and carries the slot's generation, so a handle to a slot that has since been
+/// evicted and reused is rejected instead of resolving to an unrelated value. The same `(parent, key)`
+/// path keeps its handle across stops for as long as it stays in use, which lets the client keep
+/// expansion state and re-fetch only what changed.
+///
+/// Values are only held for the current stop and are released by `endStop()`. Paths that have not been
+/// used for `retainedStopCount` stops are evicted then, and when every slot is in use the least
+/// recently used paths are evicted to make room, so memory stays bounded however long the session.
+/// Paths used during the current stop are never evicted, since the client may still hold their handles
+/// and the inspection cache hands them out again; the arena grows past `capacity` instead.
+struct HandleArena<Value> {
+    private struct Key: Hashable {
+        var parent: Int?
+        var name: String
+    }
+    
+    private struct Slot {
+        var generation = 0
+        var key: Key?
+        var value: Value?
+        var lastUsedStop = 0
+    }
+    
+    struct Statistics: Sendable {
+        var liveHandleCount = 0
+        var slotCount = 0
+        var evictionCount = 0
+    }
+    
+    private static var indexBitCount: Int { 20 }
+    private static var generationBitCount: Int { 11 }
+    
+    /// The largest number of slots, limited by the bits a handle reserves for the slot index.
+    static var maximumCapacity: Int { (1 << indexBitCount) - 1 }
+    
+    let capacity: Int
+    let retainedStopCount: Int
+    
+    private var slots: [Slot] = []
+    private var freeIndices: [Int] = []
+    private var handlesByKey: [Key: Int] = [:]
+    private var currentStop = 0
+    
+    /// The stop during which every slot was found to be in use, so that growing the arena does not
+    /// rescan it on each insertion.
+    private var fullyUsedStop: Int?
+    private(set) var evictionCount = 0
+    
+    init(capacity: Int = 1 << 18, retainedStopCount: Int = 16) {
+        self.capacity = min(max(1, capacity), Self.maximumCapacity)
+        self.retainedStopCount = max(1, retainedStopCount)
+    }
+    
+    var statistics: Statistics {
+        return Statistics(liveHandleCount: handlesByKey.count, slotCount: slots.count, evictionCount: evictionCount)
+    }
+    
+    // MARK: - Handles
+    
+    /// Handles are always positive and fit in 31 bits, as the protocol requires.
+    private static func handle(index: Int, generation: Int) -> Int {
+        return (generation << indexBitCount) | (index + 1)
+    }
+    
+    private func slotIndex(for handle: Int) -> Int? {
+        let index = (handle & ((1 << Self.indexBitCount) - 1)) - 1
+        let generation = handle >> Self.indexBitCount
+        guard index >= 0, index < slots.count, slots[index].generation == generation, slots[index].key != nil else {
+            return nil
+        }
+        return index
+    }
+    
+    /// Binds `value` to the path `(parent, key)` for the current stop, returning the path's handle, or 0,
+    /// which refers to nothing, if every possible slot is in use during the current stop.
+    @discardableResult
+    mutating func insert(parent: Int?, key: String, value: Value) -> Int {
+        let slotKey = Key(parent: parent, name: key)
+        
+        if let handle = handlesByKey[slotKey], let index = slotIndex(for: handle) {
+            slots[index].value = value
+            slots[index].lastUsedStop = currentStop
+            return handle
+        }
+        
+        guard let index = allocateSlot() else {
+            return 0
+        }
+        slots[index].key = slotKey
+        slots[index].value = value
+        slots[index].lastUsedStop = currentStop
+        
+        let handle = Self.handle(index: index, generation: slots[index].generation)
+        handlesByKey[slotKey] = handle
+        return handle
+    }
+    
+    /// The value bound to `handle` during the current stop, marking its path as recently used.
+    mutating func value(for handle: Int) -> Value? {
+        guard let index = slotIndex(for: handle), let value = slots[index].value else {
+            return nil
+        }
+        slots[index].lastUsedStop = currentStop
+        return value
+    }
+    
+    /// Releases every value bound during the stop and evicts paths that have gone unused.
+    mutating func endStop() {
+        currentStop += 1
+        
+        for index in slots.indices where slots[index].key != nil {
+            slots[index].value = nil
+            if currentStop - slots[index].lastUsedStop > retainedStopCount {
+                evictSlot(at: index)
+            }
+        }
+    }
+    
+    // MARK: - Slots
+    
+    private mutating func allocateSlot() -> Int? {
+        if freeIndices.isEmpty && slots.count >= capacity && fullyUsedStop != currentStop {
+            evictLeastRecentlyUsed()
+        }
+        if let index = freeIndices.popLast() {
+            return index
+        }
+        
+        // Every slot is bound during the current stop, or the arena is still below capacity.
+        guard slots.count < Self.maximumCapacity else {
+            return nil
+        }
+        slots.append(Slot())
+        return slots.count - 1
+    }
+    
+    private mutating func evictSlot(at index: Int) {
+        if let key = slots[index].key {
+            handlesByKey[key] = nil
+        }
+        slots[index].key = nil
+        slots[index].value = nil
+        slots[index].generation = (slots[index].generation + 1) & ((1 << Self.generationBitCount) - 1)
+        freeIndices.append(index)
+        evictionCount += 1
+    }
+    
+    /// Evicts up to the least recently used eighth of the slots at once, so that a full arena is not
+    /// rescanned on every insertion. Slots used during the current stop are kept.
+    private mutating func evictLeastRecentlyUsed() {
+        let batchCount = max(1, slots.count / 8)
+        let oldest = slots.indices
+            .filter { slots[$0].key != nil && slots[$0].lastUsedStop < currentStop }
+            .sorted { slots[$0].lastUsedStop < slots[$1].lastUsedStop }
+            .prefix(batchCount)
+        if oldest.isEmpty {
+            fullyUsedStop = currentStop
+        }
+        for index in oldest {
+            evictSlot(at: index)
+        }
+    }
+}
@@ -0,0 +1,110 @@
+import Foundation
+
+/// Remembers what was read from LLDB while the debuggee is stopped, so that repeated `stackTrace`
+/// and `variables` requests for the same stop are answered without going back to LLDB.
+///
+/// Everything cached is dropped when the debuggee continues or one of its threads jumps.
+struct InspectionCache {
+    /// An immutable description of a value, read from LLDB in a single pass.
+    struct ValueSnapshot {
+        var name: String
+        var typeName: String?
+        var value: String?
+        var summary: String?
+        var error: String?
+        var loadAddress: UInt64?
+        var expressionPath: String?
+        var hasChildren: Bool
+        
+        /// The reference under which the value's children can be requested, if it has any.
+        var variablesReference: Int?
+        var indexedChildCount: Int?
+        var namedChildCount: Int?
+    }
+    
+    /// Identifies one window of a container's children in one display format.
+    struct ChildrenKey: Hashable {
+        var containerRef: Int
+        var isHex: Bool
+        var filter: DebugAdapter.VariablesRequest.Filter?
+        var start: Int?
+        var count: Int?
+    }
+    
+    private struct FrameKey: Hashable {
+        var threadID: Int
+        var index: Int
+    }
+    
+    struct Statistics: Sendable {
+        var frameHits = 0
+        var frameMisses = 0
+        var childrenHits = 0
+        var childrenMisses = 0
+    }
+    
+    private(set) var statistics = Statistics()
+    
+    private var frames: [FrameKey: DebugAdapter.StackFrame] = [:]
+    private var frameCounts: [Int: Int] = [:]
+    private var children: [ChildrenKey: [ValueSnapshot]] = [:]
+    
+    /// Drops everything cached for the current stop.
+    mutating func invalidate() {
+        frames.removeAll()
+        frameCounts.removeAll()
+        children.removeAll()
+    }
+    
+    /// Drops cached values, which may have changed without the debuggee continuing.
+    mutating func invalidateValues() {
+        children.removeAll()
+    }
+    
+    // MARK: - Frames
+    
+    mutating func frame(threadID: Int, index: Int) -> DebugAdapter.StackFrame? {
+        let frame = frames[FrameKey(threadID: threadID, index: index)]
+        if frame != nil {
+            statistics.frameHits += 1
+        }
+        else {
+            statistics.frameMisses += 1
+        }
+        return frame
+    }
+    
+    mutating func setFrame(_ frame: DebugAdapter.StackFrame, threadID: Int, index: Int) {
+        frames[FrameKey(threadID: threadID, index: index)] = frame
+    }
+    
+    /// Records the depth of a thread's stack once it has been unwound to the end during this stop.
+    mutating func setFrameCount(_ count: Int, threadID: Int) {
+        frameCounts[threadID] = count
+    }
+    
+    /// Whether a thread's stack is known to have a frame at `index`.
+    func hasFrame(threadID: Int, index: Int) -> Bool? {
+        if frames[FrameKey(threadID: threadID, index: index)] != nil {
+            return true
+        }
+        return frameCounts[threadID].map { index < $0 }
+    }
+    
+    // MARK: - Children
+    
+    mutating func children(for key: ChildrenKey) -> [ValueSnapshot]? {
+        let snapshots = children[key]
+        if snapshots != nil {
+            statistics.childrenHits += 1
+        }
+        else {
+            statistics.childrenMisses += 1
+        }
+        return snapshots
+    }
+    
+    mutating func setChildren(_ snapshots: [ValueSnapshot], for key: ChildrenKey) {
+        children[key] = snapshots
+    }
+}
@@ -0,0 +1,43 @@
+import Foundation
+
+/// Counts durations in power-of-two microsecond buckets, so percentiles can be reported without keeping every sample.
+struct LatencyHistogram {
+    private(set) var count = 0
+    private(set) var total: Duration = .zero
+    private(set) var maximum: Duration = .zero
+    
+    /// Bucket `i` counts durations shorter than 2^i microseconds and not counted by an earlier bucket.
+    private var buckets = [Int](repeating: 0, count: 40)
+    
+    mutating func record(_ duration: Duration) {
+        count += 1
+        total += duration
+        maximum = max(maximum, duration)
+        
+        let (seconds, attoseconds) = duration.components
+        let microseconds = max(0, seconds * 1_000_000 + attoseconds / 1_000_000_000_000)
+        let index = min(buckets.count - 1, UInt64.bitWidth - UInt64(microseconds).leadingZeroBitCount)
+        buckets[index] += 1
+    }
+    
+    var mean: Duration? {
+        return count > 0 ? total / count : nil
+    }
+    
+    /// An upper bound on the duration below which `fraction` of the samples fall, or `nil` if there are none.
+    func percentile(_ fraction: Double) -> Duration? {
+        guard count > 0 else {
+            return nil
+        }
+        
+        let rank = max(1, Int((Double(count) * fraction).rounded(.up)))
+        var seen = 0
+        for (index, bucketCount) in buckets.enumerated() {
+            seen += bucketCount
+            if seen >= rank {
+                return min(maximum, .microseconds(Int64(1) << index))
+            }
+        }
+        return maximum
+    }
+}
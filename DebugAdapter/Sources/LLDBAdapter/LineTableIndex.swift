@@ -0,0 +1,138 @@
+import Foundation
+import SwiftLLDB
+
+/// Indexes the line tables of compile units by source file, so that the positions where a breakpoint
+/// can be placed in a range of lines are found with a binary search instead of a walk of the line table.
+///
+/// A compile unit is indexed the first time one of its files is looked up, including files it uses only
+/// as headers or for inlined code. Indexes are kept per module UUID, or per module path for a module
+/// without one, so a module that is rebuilt is indexed again, and one that is loaded again after being
+/// unloaded is not.
+struct LineTableIndex {
+    struct Position: Hashable, Comparable {
+        var line: Int
+        var column: Int?
+        
+        static func < (lhs: Position, rhs: Position) -> Bool {
+            if lhs.line != rhs.line {
+                return lhs.line < rhs.line
+            }
+            return (lhs.column ?? 0) < (rhs.column ?? 0)
+        }
+    }
+    
+    struct Statistics: Sendable {
+        var indexedCompileUnitCount = 0
+        var indexedLineEntryCount = 0
+        var indexDuration: Duration = .zero
+        var lookupCount = 0
+        var lookupDuration: Duration = .zero
+    }
+    
+    private struct CompileUnitKey: Hashable {
+        /// The module's UUID, or its path if it has none.
+        var moduleID: String
+        var path: String
+    }
+    
+    /// The sorted, unique positions of each source file in a compile unit's line table.
+    private var compileUnits: [CompileUnitKey: [String: [Position]]] = [:]
+    
+    /// The compile units found for each file looked up, until the target's modules change.
+    private var compileUnitKeysByPath: [String: [CompileUnitKey]] = [:]
+    
+    private(set) var statistics = Statistics()
+    
+    /// The positions in the file at `path` from `start` through `end`, in order.
+    mutating func positions(inFileAt path: String, from start: Position, through end: Position, in target: Target) -> [Position] {
+        let clock = ContinuousClock()
+        let startTime = clock.now
+        defer {
+            statistics.lookupCount += 1
+            statistics.lookupDuration += startTime.duration(to: clock.now)
+        }
+        
+        guard let path = FileSpec(path: path)?.path else {
+            return []
+        }
+        
+        let keys = compileUnitKeysByPath[path] ?? findCompileUnits(path: path, in: target)
+        
+        var result: [Position] = []
+        for key in keys {
+            guard let positions = compileUnits[key]?[path] else {
+                continue
+            }
+            
+            var index = Self.firstIndex(in: positions, notBefore: start)
+            while index < positions.count, positions[index] <= end {
+                result.append(positions[index])
+                index += 1
+            }
+        }
+        
+        // A file compiled into several modules has the same positions in each.
+        if keys.count > 1 {
+            result = Array(Set(result)).sorted()
+        }
+        return result
+    }
+    
+    /// Forgets which compile units contain each file, after modules are loaded or unloaded.
+    /// Line tables already indexed are kept, since they are tied to their module's UUID.
+    mutating func invalidateFileLookups() {
+        compileUnitKeysByPath.removeAll()
+    }
+    
+    private mutating func findCompileUnits(path: String, in target: Target) -> [CompileUnitKey] {
+        var keys: [CompileUnitKey] = []
+        for (module, compileUnit) in target.findCompileUnits(path: path) {
+            guard let moduleID = module.uuid ?? module.fileSpec?.path else {
+                continue
+            }
+            let key = CompileUnitKey(moduleID: moduleID, path: compileUnit.fileSpec?.path ?? path)
+            if compileUnits[key] == nil {
+                index(compileUnit, key: key)
+            }
+            keys.append(key)
+        }
+        compileUnitKeysByPath[path] = keys
+        return keys
+    }
+    
+    private mutating func index(_ compileUnit: CompileUnit, key: CompileUnitKey) {
+        let clock = ContinuousClock()
+        let startTime = clock.now
+        
+        var files: [String: Set<Position>] = [:]
+        let count = compileUnit.lineEntryCount
+        for i in 0 ..< count {
+            // A zero-value line means the code is compiler generated.
+            guard let lineEntry = compileUnit.lineEntry(at: i), let line = lineEntry.line, line > 0, let fileSpec = lineEntry.fileSpec else {
+                continue
+            }
+            files[fileSpec.path, default: []].insert(Position(line: line, column: lineEntry.column))
+        }
+        
+        compileUnits[key] = files.mapValues { $0.sorted() }
+        
+        statistics.indexedCompileUnitCount += 1
+        statistics.indexedLineEntryCount += count
+        statistics.indexDuration += startTime.duration(to: clock.now)
+    }
+    
+    private static func firstIndex(in positions: [Position], notBefore position: Position) -> Int {
+        var low = 0
+        var high = positions.count
+        while low < high {
+            let mid = (low + high) / 2
+            if positions[mid] < position {
+                low = mid + 1
+            }
+            else {
+                high = mid
+            }
+        }
+        return low
+    }
+}
@@ -0,0 +1,256 @@
+import Foundation
+import SwiftLLDB
+
+/// Caches memory read from a stopped process in fixed-size pages, so that the overlapping windows a
+/// memory view requests as it scrolls are read from the process only once.
+///
+/// Reads follow the boundaries of the process's memory regions: a read that runs into an unreadable
+/// region stops exactly where it starts, and reports how far it extends, instead of failing. The cache
+/// belongs to a single stop. It is dropped when the process's stop ID changes, which includes
+/// expressions that run code, and must be invalidated when the adapter writes memory.
+///
+/// The cache may be used from any lane. Its lock is held only to look up and merge pages, never while
+/// memory is read from the process or passed to the caller.
+final class MemoryCache {
+    struct Statistics: Sendable {
+        var pageHits = 0
+        var pageMisses = 0
+        var bytesRead = 0
+        var readDuration: Duration = .zero
+    }
+    
+    private struct Region {
+        var range: Range<UInt64>
+        var isReadable: Bool
+    }
+    
+    static let pageSize: UInt64 = 4096
+    
+    /// The most pages read from the process in one call.
+    private static let maximumBatchPageCount: UInt64 = 256
+    
+    /// The most pages kept before the cache is emptied.
+    private static let maximumPageCount = 8192
+    
+    private struct State {
+        var processID: UInt64?
+        var stopID: UInt32?
+        
+        /// The bytes that could be read from each page, keyed by the page's address.
+        /// A page shorter than `pageSize` ends where memory became unreadable.
+        var pages: [UInt64: [UInt8]] = [:]
+        
+        /// The process's memory regions in ascending order, listed when first needed. Empty if the
+        /// platform cannot list them, in which case each page is read to find out whether it is readable.
+        var regions: [Region]?
+    }
+    
+    private let state = Locked(State())
+    
+    /// Kept apart from `state`, so that reading the statistics never waits for pages to be merged.
+    private let statisticsSnapshot = Locked(Statistics())
+    
+    var statistics: Statistics {
+        return statisticsSnapshot.withLock { $0 }
+    }
+    
+    /// Reads up to `count` bytes from `address`, passing each run of bytes to `body` in order.
+    ///
+    /// Reading stops at the first unreadable byte. Returns the number of bytes read, and the number of
+    /// unreadable bytes after them within the requested range, which a client skips before reading again.
+    func read(at address: UInt64, count: Int, from process: Process, _ body: (UnsafeRawBufferPointer) -> Void) -> (readCount: Int, unreadableCount: Int) {
+        validate(for: process)
+        
+        let (sum, overflow) = address.addingReportingOverflow(UInt64(max(0, count)))
+        let end = overflow ? UInt64.max : sum
+        
+        var position = address
+        while position < end {
+            let pageAddress = position & ~(Self.pageSize - 1)
+            let page = self.page(at: pageAddress, before: end, from: process)
+            
+            let offset = Int(position - pageAddress)
+            guard offset < page.count else {
+                let unreadableEnd = endOfUnreadableMemory(from: position, before: end, in: process)
+                return (Int(position - address), Int(unreadableEnd - position))
+            }
+            
+            let length = min(page.count - offset, Int(end - position))
+            page.withUnsafeBytes { bytes in
+                body(UnsafeRawBufferPointer(rebasing: bytes[offset ..< offset + length]))
+            }
+            position += UInt64(length)
+        }
+        
+        return (Int(position - address), 0)
+    }
+    
+    func invalidate() {
+        state.withLock { state in
+            state.pages.removeAll()
+            state.regions = nil
+        }
+    }
+    
+    /// Drops the pages overlapping memory that was written.
+    func invalidate(addresses: Range<UInt64>) {
+        state.withLock { state in
+            var pageAddress = addresses.lowerBound & ~(Self.pageSize - 1)
+            while pageAddress < addresses.upperBound {
+                state.pages[pageAddress] = nil
+                
+                let (next, overflow) = pageAddress.addingReportingOverflow(Self.pageSize)
+                if overflow {
+                    break
+                }
+                pageAddress = next
+            }
+        }
+    }
+    
+    private func validate(for process: Process) {
+        let processID = process.processID
+        let stopID = process.stopID(includingExpressionStops: true)
+        state.withLock { state in
+            if processID != state.processID || stopID != state.stopID {
+                state.pages.removeAll()
+                state.regions = nil
+                state.processID = processID
+                state.stopID = stopID
+            }
+        }
+    }
+    
+    // MARK: - Pages
+    
+    /// The page at `pageAddress`, reading it and the uncached pages after it, up to `end`, if it is not cached.
+    private func page(at pageAddress: UInt64, before end: UInt64, from process: Process) -> [UInt8] {
+        if let cached = state.withLock({ $0.pages[pageAddress] }) {
+            statisticsSnapshot.withLock { $0.pageHits += 1 }
+            return cached
+        }
+        
+        let region = self.region(containing: pageAddress, in: process)
+        if let region, !region.isReadable {
+            state.withLock { $0.pages[pageAddress] = [] }
+            statisticsSnapshot.withLock { $0.pageMisses += 1 }
+            return []
+        }
+        
+        // Read the run of uncached pages within the region in a single call.
+        let limit = min(end, region?.range.upperBound ?? .max)
+        let pageCount = state.withLock { state -> UInt64 in
+            var pageCount: UInt64 = 1
+            while pageCount < Self.maximumBatchPageCount {
+                let next = pageAddress &+ pageCount * Self.pageSize
+                guard next > pageAddress, next < limit, state.pages[next] == nil else {
+                    break
+                }
+                pageCount += 1
+            }
+            return pageCount
+        }
+        
+        let clock = ContinuousClock()
+        let startTime = clock.now
+        
+        let pageSize = Int(Self.pageSize)
+        let bytes = Self.readMemory(count: Int(pageCount) * pageSize, at: pageAddress, from: process)
+        var readPages: [[UInt8]] = []
+        for index in 0 ..< Int(pageCount) {
+            let lowerBound = index * pageSize
+            if lowerBound < bytes.count {
+                readPages.append(Array(bytes[lowerBound ..< min(bytes.count, lowerBound + pageSize)]))
+            }
+            else {
+                // Memory may become readable again after a short read, when there are no regions to say where.
+                readPages.append(Self.readMemory(count: pageSize, at: pageAddress + UInt64(lowerBound), from: process))
+            }
+        }
+        
+        let duration = startTime.duration(to: clock.now)
+        
+        state.withLock { state in
+            if state.pages.count + readPages.count > Self.maximumPageCount {
+                state.pages.removeAll()
+            }
+            for (index, page) in readPages.enumerated() {
+                state.pages[pageAddress + UInt64(index * pageSize)] = page
+            }
+        }
+        statisticsSnapshot.withLock { statistics in
+            statistics.pageMisses += readPages.count
+            statistics.bytesRead += readPages.reduce(0) { $0 + $1.count }
+            statistics.readDuration += duration
+        }
+        
+        return readPages[0]
+    }
+    
+    private static func readMemory(count: Int, at address: UInt64, from process: Process) -> [UInt8] {
+        return [UInt8](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            initializedCount = (try? process.readMemory(buffer, at: address)) ?? 0
+        }
+    }
+    
+    /// The end of the unreadable memory starting at `address`, which is at most `end`.
+    private func endOfUnreadableMemory(from address: UInt64, before end: UInt64, in process: Process) -> UInt64 {
+        var position = address
+        while position < end {
+            if let region = self.region(containing: position, in: process), !region.isReadable {
+                position = region.range.upperBound
+                continue
+            }
+            
+            let pageAddress = position & ~(Self.pageSize - 1)
+            if position - pageAddress < UInt64(page(at: pageAddress, before: end, from: process).count) {
+                return position
+            }
+            
+            let (next, overflow) = pageAddress.addingReportingOverflow(Self.pageSize)
+            if overflow {
+                return end
+            }
+            position = next
+        }
+        return min(position, end)
+    }
+    
+    // MARK: - Regions
+    
+    /// The region containing `address`, or the unmapped gap between regions, or `nil` if the regions cannot be listed.
+    private func region(containing address: UInt64, in process: Process) -> Region? {
+        var regions = state.withLock { $0.regions }
+        if regions == nil {
+            let listed = process.memoryRegions
+                .map { Region(range: $0.range, isReadable: $0.isReadable) }
+                .filter { !$0.range.isEmpty }
+                .sorted { $0.range.lowerBound < $1.range.lowerBound }
+            state.withLock { $0.regions = listed }
+            regions = listed
+        }
+        guard let regions, !regions.isEmpty else {
+            return nil
+        }
+        
+        var low = 0
+        var high = regions.count
+        while low < high {
+            let mid = (low + high) / 2
+            if regions[mid].range.lowerBound <= address {
+                low = mid + 1
+            }
+            else {
+                high = mid
+            }
+        }
+        
+        if low > 0, regions[low - 1].range.contains(address) {
+            return regions[low - 1]
+        }
+        
+        let gapStart = low > 0 ? regions[low - 1].range.upperBound : 0
+        let gapEnd = low < regions.count ? regions[low].range.lowerBound : .max
+        return Region(range: gapStart ..< gapEnd, isReadable: false)
+    }
+}
@@ -0,0 +1,260 @@
+import Foundation
+import SwiftLLDB
+
+/// Searches a stopped process's memory for a pattern with LLDB's `FindRangesInMemory`, so that the
+/// memory is scanned within the adapter instead of being read by the client window by window.
+///
+/// The selected regions are searched in chunks, so that progress can be reported and the search
+/// cancelled between them. Each chunk extends one byte less than the pattern's length past the next
+/// one's start, so a match that straddles the boundary is found exactly once.
+///
+/// LLDB does not say which regions are stacks or heaps, so they are told apart by heuristics: a stack
+/// is a region containing the stack pointer of a thread's innermost frame, and heap memory is any other
+/// region that is writable, not executable and not mapped from a file.
+struct MemorySearch {
+    static let command = "icarus/searchMemory"
+    
+    struct Arguments: Codable, Sendable {
+        enum Regions: String, Codable, Sendable {
+            case heap
+            case stack
+            case all
+        }
+        
+        enum ValueType: String, Codable, Sendable {
+            case int8
+            case int16
+            case int32
+            case int64
+            case uint8
+            case uint16
+            case uint32
+            case uint64
+            case pointer
+            case float
+            case double
+            case string
+        }
+        
+        /// The bytes to find, base64-encoded as for `writeMemory`.
+        var data: String?
+        
+        /// A value to find if `data` is not given, encoded as `type` in the process's byte order.
+        /// Integers may be given in hexadecimal with a `0x` prefix, and strings are encoded as UTF-8.
+        var value: String?
+        var type: ValueType?
+        
+        /// The regions searched, which defaults to all readable memory.
+        var regions: Regions?
+        
+        /// A number that each match's address must be a multiple of. Defaults to the size of `type`
+        /// for numbers and pointers, and to 1 for bytes and strings.
+        var alignment: Int?
+        
+        /// The most matches returned, which defaults to 100.
+        var maxMatches: Int?
+    }
+    
+    struct Result: Codable, Sendable {
+        struct Match: Codable, Sendable {
+            var memoryReference: String
+            
+            /// The name of the region containing the match, such as the path of a mapped file, if it has one.
+            var regionName: String?
+        }
+        
+        var matches: [Match]
+        var searchedBytes: Int
+        
+        /// Whether the search stopped at `maxMatches` before all of the selected memory was searched.
+        var isTruncated: Bool
+    }
+    
+    private struct Region {
+        var range: Range<UInt64>
+        var name: String?
+    }
+    
+    private static let defaultMaximumMatchCount = 100
+    private static let maximumMatchCountLimit = 10_000
+    
+    /// The most bytes searched between progress reports and cancellation checks.
+    private static let chunkSize: UInt64 = 64 << 20
+    
+    let pattern: [UInt8]
+    let regions: Arguments.Regions
+    let alignment: Int
+    let maximumMatchCount: Int
+    
+    init(_ arguments: Arguments, byteOrder: ByteOrder, addressByteSize: Int) throws {
+        if let data = arguments.data {
+            guard let bytes = Data(base64Encoded: data) else {
+                throw Adapter.AdapterError.invalidParameter("Invalid base64-encoded data.")
+            }
+            pattern = Array(bytes)
+        }
+        else if let value = arguments.value, let type = arguments.type {
+            pattern = try Self.encode(value, as: type, byteOrder: byteOrder, addressByteSize: addressByteSize)
+        }
+        else {
+            throw Adapter.AdapterError.invalidParameter("A search requires either data, or a value and its type.")
+        }
+        
+        guard !pattern.isEmpty else {
+            throw Adapter.AdapterError.invalidParameter("The search pattern is empty.")
+        }
+        
+        let alignment = arguments.alignment ?? Self.naturalAlignment(of: arguments.type, addressByteSize: addressByteSize)
+        guard alignment > 0, UInt64(alignment) <= MemoryCache.pageSize, alignment & (alignment - 1) == 0 else {
+            throw Adapter.AdapterError.invalidParameter("Invalid alignment “\(alignment)”.")
+        }
+        
+        let maximumMatchCount = arguments.maxMatches ?? Self.defaultMaximumMatchCount
+        guard maximumMatchCount > 0 else {
+            throw Adapter.AdapterError.invalidParameter("Invalid maximum match count “\(maximumMatchCount)”.")
+        }
+        
+        self.regions = arguments.regions ?? .all
+        self.alignment = alignment
+        self.maximumMatchCount = min(maximumMatchCount, Self.maximumMatchCountLimit)
+    }
+    
+    /// Searches the selected regions of `process`, calling `checkCancellation` before each chunk, and
+    /// `progress` with the fraction of memory searched after it.
+    func run(in process: Process, formatAddress: (UInt64) -> String, checkCancellation: () throws -> Void, progress: (Double) -> Void) throws -> Result {
+        let searchedRegions = try selectedRegions(in: process)
+        let totalBytes = searchedRegions.reduce(0) { $0 + ($1.range.upperBound - $1.range.lowerBound) }
+        let overlap = UInt64(pattern.count - 1)
+        
+        var matches: [Result.Match] = []
+        var searchedBytes: UInt64 = 0
+        
+        search: for region in searchedRegions {
+            var start = region.range.lowerBound
+            while start < region.range.upperBound {
+                try checkCancellation()
+                
+                let boundary = region.range.upperBound - start > Self.chunkSize ? start + Self.chunkSize : region.range.upperBound
+                let end = region.range.upperBound - boundary > overlap ? boundary + overlap : region.range.upperBound
+                
+                if end - start >= UInt64(pattern.count) {
+                    let found = try process.findInMemory(pattern, in: [start ..< end], alignment: alignment, maximumMatchCount: maximumMatchCount - matches.count)
+                    for address in found {
+                        matches.append(Result.Match(memoryReference: formatAddress(address), regionName: region.name))
+                    }
+                }
+                
+                searchedBytes += boundary - start
+                progress(Double(searchedBytes) / Double(totalBytes))
+                start = boundary
+                
+                if matches.count >= maximumMatchCount {
+                    break search
+                }
+            }
+        }
+        
+        return Result(matches: Array(matches.prefix(maximumMatchCount)), searchedBytes: Int(searchedBytes), isTruncated: searchedBytes < totalBytes)
+    }
+    
+    // MARK: - Regions
+    
+    private func selectedRegions(in process: Process) throws -> [Region] {
+        let readableRegions = process.memoryRegions.filter { $0.isMapped && $0.isReadable && !$0.range.isEmpty }
+        guard !readableRegions.isEmpty else {
+            throw Adapter.AdapterError.invalidParameter("The process’s memory regions cannot be listed.")
+        }
+        
+        let stackPointers = process.threads.compactMap { $0.frame(at: 0)?.stackPointer }
+        func isStack(_ region: MemoryRegionInfo) -> Bool {
+            return stackPointers.contains { region.range.contains($0) }
+        }
+        
+        let selectedRegions: [MemoryRegionInfo]
+        switch regions {
+        case .all:
+            selectedRegions = readableRegions
+        case .stack:
+            selectedRegions = readableRegions.filter { isStack($0) }
+        case .heap:
+            selectedRegions = readableRegions.filter { $0.isWritable && !$0.isExecutable && $0.name == nil && !isStack($0) }
+        }
+        
+        return selectedRegions.map { Region(range: $0.range, name: $0.name) }
+    }
+    
+    // MARK: - Patterns
+    
+    private static func naturalAlignment(of type: Arguments.ValueType?, addressByteSize: Int) -> Int {
+        switch type {
+        case .int8, .uint8, .string, nil:
+            return 1
+        case .int16, .uint16:
+            return 2
+        case .int32, .uint32, .float:
+            return 4
+        case .int64, .uint64, .double:
+            return 8
+        case .pointer:
+            return addressByteSize
+        }
+    }
+    
+    private static func encode(_ value: String, as type: Arguments.ValueType, byteOrder: ByteOrder, addressByteSize: Int) throws -> [UInt8] {
+        func integer<T: FixedWidthInteger>(_: T.Type) throws -> [UInt8] {
+            let parsed: T?
+            if let r = value.range(of: "0x", options: [.anchored]) {
+                parsed = T(value[r.upperBound...], radix: 16)
+            }
+            else if let r = value.range(of: "-0x", options: [.anchored]) {
+                parsed = T("-" + value[r.upperBound...], radix: 16)
+            }
+            else {
+                parsed = T(value)
+            }
+            
+            guard let parsed else {
+                throw Adapter.AdapterError.invalidParameter("Invalid \(type.rawValue) value “\(value)”.")
+            }
+            return bytes(of: parsed, byteOrder: byteOrder)
+        }
+        
+        switch type {
+        case .int8:
+            return try integer(Int8.self)
+        case .int16:
+            return try integer(Int16.self)
+        case .int32:
+            return try integer(Int32.self)
+        case .int64:
+            return try integer(Int64.self)
+        case .uint8:
+            return try integer(UInt8.self)
+        case .uint16:
+            return try integer(UInt16.self)
+        case .uint32:
+            return try integer(UInt32.self)
+        case .uint64:
+            return try integer(UInt64.self)
+        case .pointer:
+            return try addressByteSize == 4 ? integer(UInt32.self) : integer(UInt64.self)
+        case .float:
+            guard let float = Float(value) else {
+                throw Adapter.AdapterError.invalidParameter("Invalid float value “\(value)”.")
+            }
+            return bytes(of: float.bitPattern, byteOrder: byteOrder)
+        case .double:
+            guard let double = Double(value) else {
+                throw Adapter.AdapterError.invalidParameter("Invalid double value “\(value)”.")
+            }
+            return bytes(of: double.bitPattern, byteOrder: byteOrder)
+        case .string:
+            return Array(value.utf8)
+        }
+    }
+    
+    private static func bytes<T: FixedWidthInteger>(of value: T, byteOrder: ByteOrder) -> [UInt8] {
+        let ordered = byteOrder == .bigEndian ? value.bigEndian : value.littleEndian
+        return withUnsafeBytes(of: ordered) { Array($0) }
+    }
+}
@@ -0,0 +1,127 @@
+import Foundation
+
+/// Batches one of the debuggee's output streams, or its logpoint messages, into fewer, larger `output` events.
+///
+/// Bytes are decoded as UTF-8 when flushed, holding back an incomplete trailing sequence until the
+/// rest of it arrives. Output is flushed once `maximumLength` bytes are buffered or `interval` has
+/// passed since the first unflushed byte. When more than `rateLimit` bytes per second arrive, the part
+/// of each read beyond the budget is dropped, and each flush ends with a marker noting how many bytes
+/// were elided since the last one.
+final class OutputCoalescer {
+    struct Options {
+        /// The time to wait for more output before flushing.
+        var interval: TimeInterval = 0.05
+        
+        /// The number of buffered bytes that triggers an immediate flush.
+        var maximumLength = 64 * 1024
+        
+        /// The number of bytes per second forwarded before output is elided, or `nil` for no limit.
+        var rateLimit: Int? = 4 * 1024 * 1024
+    }
+    
+    private let options: Options
+    private let queue: DispatchQueue
+    private let handler: (String) -> Void
+    
+    private var buffer: [UInt8] = []
+    private var isFlushScheduled = false
+    
+    private var rateBudget: Double
+    private var rateBudgetDate = ContinuousClock.now
+    private var elidedByteCount = 0
+    
+    /// Creates a coalescer which must only be used from `queue`, where `handler` is invoked with each flushed string.
+    init(options: Options, queue: DispatchQueue, handler: @escaping (String) -> Void) {
+        self.options = options
+        self.queue = queue
+        self.handler = handler
+        self.rateBudget = Double(options.rateLimit ?? 0)
+    }
+    
+    func append(_ bytes: UnsafeBufferPointer<UInt8>) {
+        guard !bytes.isEmpty else {
+            return
+        }
+        
+        var bytes = bytes
+        if let rateLimit = options.rateLimit {
+            // Token bucket allowing up to one second of burst.
+            let now = ContinuousClock.now
+            let elapsed = rateBudgetDate.duration(to: now)
+            rateBudgetDate = now
+            let seconds = Double(elapsed.components.seconds) + Double(elapsed.components.attoseconds) / 1e18
+            rateBudget = min(Double(rateLimit), rateBudget + seconds * Double(rateLimit))
+            
+            if Double(bytes.count) > rateBudget {
+                // Send the part of the read within the budget, ending on a whole UTF-8 sequence.
+                let allowedLength = Self.completeUTF8Length(of: Array(bytes.prefix(Int(rateBudget))))
+                elidedByteCount += bytes.count - allowedLength
+                bytes = UnsafeBufferPointer(rebasing: bytes[0 ..< allowedLength])
+            }
+            rateBudget -= Double(bytes.count)
+        }
+        
+        buffer.append(contentsOf: bytes)
+        
+        if buffer.count >= options.maximumLength || options.interval <= 0 {
+            flush()
+        }
+        else {
+            scheduleFlush()
+        }
+    }
+    
+    /// Sends all buffered output. Unless `isFinal`, an incomplete trailing UTF-8 sequence is held back.
+    func flush(isFinal: Bool = false) {
+        let length = isFinal ? buffer.count : Self.completeUTF8Length(of: buffer)
+        if length > 0 {
+            handler(String(decoding: buffer[0 ..< length], as: UTF8.self))
+            buffer.removeFirst(length)
+        }
+        
+        if elidedByteCount > 0 {
+            handler("\n[\(elidedByteCount) bytes of output elided]\n")
+            elidedByteCount = 0
+        }
+    }
+    
+    private func scheduleFlush() {
+        guard !isFlushScheduled else {
+            return
+        }
+        isFlushScheduled = true
+        
+        queue.asyncAfter(deadline: .now() + options.interval) { [weak self] in
+            guard let self else {
+                return
+            }
+            self.isFlushScheduled = false
+            self.flush()
+        }
+    }
+    
+    /// The length of the prefix of `bytes` that does not end partway through a UTF-8 sequence.
+    private static func completeUTF8Length(of bytes: [UInt8]) -> Int {
+        // Find the start of the last sequence, looking back no further than the longest sequence length.
+        var index = bytes.count - 1
+        while index >= 0 && index >= bytes.count - 4 {
+            let byte = bytes[index]
+            if byte & 0b1100_0000 != 0b1000_0000 {
+                let sequenceLength: Int
+                switch byte {
+                case 0b1111_0000...:
+                    sequenceLength = 4
+                case 0b1110_0000...:
+                    sequenceLength = 3
+                case 0b1100_0000...:
+                    sequenceLength = 2
+                default:
+                    sequenceLength = 1
+                }
+                return bytes.count - index >= sequenceLength ? bytes.count : index
+            }
+            index -= 1
+        }
+        return bytes.count
+    }
+}
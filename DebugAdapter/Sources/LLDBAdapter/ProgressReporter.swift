@@ -0,0 +1,174 @@
+import Foundation
+import SwiftLLDB
+
+/// Forwards LLDB's progress reports as `progressStart`, `progressUpdate` and `progressEnd` events.
+///
+/// Work that finishes within `startDelay` is never shown, since LLDB reports many short tasks, such as
+/// loading each module's symbols. Updates to work that is shown are sent at most once per
+/// `updateInterval`, with only the latest one sent. Once all work has finished, if it took long
+/// enough, a summary of the longest tasks is reported.
+final class ProgressReporter {
+    struct Options {
+        /// Whether progress events are sent, which requires the client to support them. Work is timed either way.
+        var showsProgress = true
+        
+        /// The time work must take before it is shown.
+        var startDelay: Duration = .milliseconds(500)
+        
+        /// The minimum time between updates to the same work.
+        var updateInterval: Duration = .milliseconds(250)
+        
+        /// The total time that work must take before a summary is reported.
+        var summaryThreshold: Duration = .seconds(1)
+        
+        /// The number of tasks listed in a summary.
+        var summaryLength = 5
+    }
+    
+    struct Timing: Sendable {
+        var title: String
+        var details: String?
+        var duration: Duration
+    }
+    
+    private struct Progress {
+        var title: String
+        var details: String?
+        var startedAt: ContinuousClock.Instant
+        var isShown = false
+        var message: String?
+        var percentage: Int?
+        var lastUpdateAt: ContinuousClock.Instant?
+        var isUpdatePending = false
+        var isUpdateScheduled = false
+    }
+    
+    private let options: Options
+    private let queue: DispatchQueue
+    private let connection: DebugAdapterConnection
+    private let summaryHandler: (String) -> Void
+    
+    private var progresses: [UInt64: Progress] = [:]
+    
+    /// Every task that finished, for statistics, and those not yet included in a summary.
+    private(set) var timings: [Timing] = []
+    private var unsummarizedTimings: [Timing] = []
+    
+    /// Creates a reporter which must only be used from `queue`, where `summaryHandler` is invoked with each summary.
+    init(options: Options, connection: DebugAdapterConnection, queue: DispatchQueue, summaryHandler: @escaping (String) -> Void) {
+        self.options = options
+        self.connection = connection
+        self.queue = queue
+        self.summaryHandler = summaryHandler
+    }
+    
+    /// Handles a report from LLDB, timing the work from when its reports were received.
+    func handle(_ event: ProgressEvent, receivedAt: ContinuousClock.Instant) {
+        let percentage = event.total.flatMap { total in
+            total > 0 ? Int(min(100, Double(event.completed) / Double(total) * 100)) : nil
+        }
+        
+        if event.isFinished {
+            finish(id: event.id, at: receivedAt)
+        }
+        else if progresses[event.id] != nil {
+            progresses[event.id]?.message = event.details ?? event.message
+            progresses[event.id]?.percentage = percentage
+            progresses[event.id]?.isUpdatePending = true
+            sendUpdate(id: event.id)
+        }
+        else {
+            progresses[event.id] = Progress(title: event.title, details: event.details, startedAt: receivedAt, message: event.details, percentage: percentage)
+            if options.showsProgress {
+                perform(after: options.startDelay) { [weak self] in
+                    self?.show(id: event.id)
+                }
+            }
+        }
+    }
+    
+    private func show(id: UInt64) {
+        guard var progress = progresses[id], !progress.isShown else {
+            return
+        }
+        progress.isShown = true
+        progress.isUpdatePending = false
+        progress.lastUpdateAt = .now
+        progresses[id] = progress
+        
+        var event = DebugAdapter.ProgressStartEvent(progressId: String(id), title: progress.title)
+        event.message = progress.message
+        event.percentage = progress.percentage
+        connection.send(event)
+    }
+    
+    private func sendUpdate(id: UInt64) {
+        guard var progress = progresses[id], progress.isShown, progress.isUpdatePending, !progress.isUpdateScheduled else {
+            return
+        }
+        
+        let now = ContinuousClock.now
+        if let lastUpdateAt = progress.lastUpdateAt, lastUpdateAt.duration(to: now) < options.updateInterval {
+            progress.isUpdateScheduled = true
+            progresses[id] = progress
+            perform(after: options.updateInterval - lastUpdateAt.duration(to: now)) { [weak self] in
+                self?.progresses[id]?.isUpdateScheduled = false
+                self?.sendUpdate(id: id)
+            }
+            return
+        }
+        
+        progress.isUpdatePending = false
+        progress.lastUpdateAt = now
+        progresses[id] = progress
+        
+        var event = DebugAdapter.ProgressUpdateEvent(progressId: String(id))
+        event.message = progress.message
+        event.percentage = progress.percentage
+        connection.send(event)
+    }
+    
+    private func finish(id: UInt64, at date: ContinuousClock.Instant) {
+        guard let progress = progresses.removeValue(forKey: id) else {
+            return
+        }
+        
+        if progress.isShown {
+            connection.send(DebugAdapter.ProgressEndEvent(progressId: String(id)))
+        }
+        
+        let timing = Timing(title: progress.title, details: progress.details, duration: progress.startedAt.duration(to: date))
+        timings.append(timing)
+        unsummarizedTimings.append(timing)
+        
+        if progresses.isEmpty {
+            summarize()
+        }
+    }
+    
+    private func summarize() {
+        let total = unsummarizedTimings.reduce(Duration.zero) { $0 + $1.duration }
+        guard total >= options.summaryThreshold else {
+            return
+        }
+        
+        let longest = unsummarizedTimings.sorted { $0.duration > $1.duration }.prefix(options.summaryLength)
+        unsummarizedTimings.removeAll()
+        
+        var summary = String(format: "LLDB reported %.1f s of work. Longest:", Self.seconds(total))
+        for timing in longest {
+            let name = timing.details.map { "\(timing.title) (\($0))" } ?? timing.title
+            summary += String(format: "\n  %7.1f s  ", Self.seconds(timing.duration)) + name
+        }
+        summaryHandler(summary)
+    }
+    
+    private func perform(after delay: Duration, _ work: @escaping () -> Void) {
+        queue.asyncAfter(deadline: .now() + Self.seconds(delay), execute: work)
+    }
+    
+    private static func seconds(_ duration: Duration) -> Double {
+        let (seconds, attoseconds) = duration.components
+        return Double(seconds) + Double(attoseconds) / 1e18
+    }
+}
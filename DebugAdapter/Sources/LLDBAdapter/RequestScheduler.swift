@@ -0,0 +1,299 @@
+import Dispatch
+import Foundation
+
+/// Runs each incoming request on a lane suited to its cost, so slow LLDB work such as a JIT-compiled
+/// expression does not hold up `pause`, `threads` or `disconnect`.
+///
+/// The scheduler itself is only used from the main queue, where the connection delivers requests.
+///
+/// Thread ownership:
+/// - The main queue owns the adapter's session state: `debugger`, `target`, the breakpoint tables and
+///   the output coalescers. Control and breakpoint requests and LLDB events are handled there, and it
+///   is the only place SBDebugger, SBTarget, SBProcess and SBBreakpoint objects are created, launched,
+///   resumed, stopped or destroyed.
+/// - The inspection lane reads SBProcess, SBThread, SBFrame and SBValue objects of a stopped process.
+/// - The evaluation lane runs expressions and commands, disassembles, and reads, writes and searches
+///   memory through SBFrame, SBTarget, SBProcess and SBCommandInterpreter.
+///
+/// Adapter state written from more than one lane, such as the variable handle arena and the
+/// inspection, disassembly and memory caches, is guarded by a lock. Background lanes read `debugger`,
+/// `target` and `clientOptions` without locking, which is safe because only exclusive requests
+/// replace them.
+///
+/// Ordering:
+/// - Requests in the same lane start in the order they arrive.
+/// - An exclusive request starts only after every earlier request has finished, and every later
+///   request waits for it. Requests that resume, restart or end the debuggee, or change its state
+///   behind the client's back, are exclusive, so inspection never observes a running process and a
+///   `setVariable` is always visible to the `variables` request that follows it.
+/// - Control and breakpoint requests share the main queue, so breakpoints set before
+///   `configurationDone` or `continue` are always in place when the debuggee starts running.
+final class RequestScheduler {
+    enum Lane {
+        /// Lifecycle and execution control, on the main queue.
+        case control
+        
+        /// Breakpoint mutation, on the main queue.
+        case breakpoints
+        
+        /// Cheap reads of a stopped process.
+        case inspection
+        
+        /// Expressions, disassembly and memory access, which may take arbitrarily long.
+        case evaluation
+    }
+    
+    struct Classification {
+        var lane: Lane
+        
+        /// Whether the request waits for all earlier requests and holds back all later ones.
+        var isExclusive = false
+        
+        /// Whether LLDB work in flight is interrupted when the request has to wait for it.
+        var interruptsWork = false
+    }
+    
+    static func classification(for command: String) -> Classification {
+        switch command {
+        case DebugAdapter.DisconnectRequest.command,
+            DebugAdapter.TerminateRequest.command,
+            DebugAdapter.RestartRequest<JSONValue>.command:
+            return Classification(lane: .control, isExclusive: true, interruptsWork: true)
+        
+        case DebugAdapter.InitializeRequest.command,
+            DebugAdapter.LaunchRequest<JSONValue>.command,
+            DebugAdapter.AttachRequest<JSONValue>.command,
+            DebugAdapter.ConfigurationDoneRequest.command,
+            DebugAdapter.ContinueRequest.command,
+            DebugAdapter.NextRequest.command,
+            DebugAdapter.StepInRequest.command,
+            DebugAdapter.StepOutRequest.command,
+            DebugAdapter.StepBackRequest.command,
+            DebugAdapter.ReverseContinueRequest.command,
+            DebugAdapter.RestartFrameRequest.command,
+            DebugAdapter.GotoRequest.command,
+            DebugAdapter.TerminateThreadsRequest.command:
+            return Classification(lane: .control, isExclusive: true)
+        
+        case DebugAdapter.SetBreakpointsRequest.command,
+            DebugAdapter.SetFunctionBreakpointsRequest.command,
+            DebugAdapter.SetInstructionBreakpointsRequest.command,
+            DebugAdapter.SetExceptionBreakpointsRequest.command,
+            DebugAdapter.SetDataBreakpointsRequest.command,
+            DebugAdapter.DataBreakpointInfoRequest.command,
+            DebugAdapter.BreakpointLocationsRequest.command:
+            return Classification(lane: .breakpoints)
+        
+        case DebugAdapter.ThreadsRequest.command,
+            DebugAdapter.StackTraceRequest.command,
+            DebugAdapter.ScopesRequest.command,
+            DebugAdapter.VariablesRequest.command:
+            return Classification(lane: .inspection)
+        
+        case DebugAdapter.EvaluateRequest.command,
+            DebugAdapter.CompletionsRequest.command,
+            DebugAdapter.DisassembleRequest.command,
+            DebugAdapter.ReadMemoryRequest.command,
+            MemorySearch.command:
+            return Classification(lane: .evaluation)
+        
+        case DebugAdapter.SetVariableRequest.command,
+            DebugAdapter.SetExpressionRequest.command,
+            DebugAdapter.WriteMemoryRequest.command:
+            return Classification(lane: .evaluation, isExclusive: true)
+        
+        default:
+            // Includes `pause`, which must not wait for an expression that is still running.
+            return Classification(lane: .control)
+        }
+    }
+    
+    typealias Work = (DebugAdapterConnection.IncomingRequest) -> Void
+    
+    private struct Item {
+        var request: DebugAdapterConnection.IncomingRequest
+        var classification: Classification
+        var work: Work
+    }
+    
+    /// The request being handled by the lane of the current queue.
+    private final class LaneContext {
+        var request: DebugAdapterConnection.IncomingRequest?
+    }
+    
+    private static let laneContextKey = DispatchSpecificKey<LaneContext>()
+    
+    private let mainContext = LaneContext()
+    private let inspectionContext = LaneContext()
+    private let evaluationContext = LaneContext()
+    
+    private let inspectionQueue = DispatchQueue(label: "com.panic.debugadapter.inspection", qos: .userInitiated)
+    private let evaluationQueue = DispatchQueue(label: "com.panic.debugadapter.evaluation", qos: .userInitiated)
+    
+    /// Requests waiting behind an exclusive request, in arrival order.
+    private var pendingItems: [Item] = []
+    private var inFlightCount = 0
+    private var isInterrupting = false
+    
+    /// Whether an exclusive request has started and not yet finished, during which every request waits.
+    private var isBarrierInFlight = false
+    
+    /// Invoked when an interrupting request has to wait for work in flight.
+    var interruptHandler: (() -> Void)?
+    
+    /// Invoked once work in flight has finished after `interruptHandler` was invoked.
+    var cancelInterruptHandler: (() -> Void)?
+    
+    /// Requests running on any lane, and interrupts deferred until the request they target runs alone.
+    ///
+    /// While a cancelled request has LLDB interrupted, no inspection or evaluation request starts, since
+    /// LLDB would abort it too. The interrupt lasts until the cancelled request finishes.
+    private struct RunningWork {
+        var count = 0
+        var deferredInterrupts: [() -> Void] = []
+        var isCancellationInterruptActive = false
+    }
+    private let runningWork = Locked(RunningWork())
+    
+    init() {
+        DispatchQueue.main.setSpecific(key: Self.laneContextKey, value: mainContext)
+        inspectionQueue.setSpecific(key: Self.laneContextKey, value: inspectionContext)
+        evaluationQueue.setSpecific(key: Self.laneContextKey, value: evaluationContext)
+    }
+    
+    /// The request being handled on the current queue, if it is one of the scheduler's lanes.
+    static var currentRequest: DebugAdapterConnection.IncomingRequest? {
+        return DispatchQueue.getSpecific(key: laneContextKey)?.request
+    }
+    
+    func schedule(_ request: DebugAdapterConnection.IncomingRequest, _ work: @escaping Work) {
+        dispatchPrecondition(condition: .onQueue(.main))
+        
+        let item = Item(request: request, classification: Self.classification(for: request.command), work: work)
+        
+        if !pendingItems.isEmpty || isBarrierInFlight || (item.classification.isExclusive && inFlightCount > 0) || !reserve(item) {
+            pendingItems.append(item)
+            
+            if item.classification.interruptsWork && inFlightCount > 0 && !isInterrupting {
+                isInterrupting = true
+                interruptHandler?()
+            }
+            return
+        }
+        
+        start(item)
+    }
+    
+    /// Invokes `interrupt` once the request being handled is the only one running, which may be at once.
+    ///
+    /// Interrupting LLDB stops every operation in progress on any thread, so a request cancelled while
+    /// another lane is busy is not interrupted until that lane finishes. Until then it relies on checking
+    /// for cancellation between units of work. Once interrupted, background requests are held back until
+    /// the request finishes. `interrupt` may be invoked after the request has finished, and must do
+    /// nothing in that case.
+    func interruptWhenRunningAlone(_ interrupt: @escaping () -> Void) {
+        let isRunningAlone = runningWork.withLock { work -> Bool in
+            if work.count <= 1 {
+                // Once nothing is running, the request has finished and `interrupt` does nothing.
+                if work.count == 1 {
+                    work.isCancellationInterruptActive = true
+                }
+                return true
+            }
+            work.deferredInterrupts.append(interrupt)
+            return false
+        }
+        if isRunningAlone {
+            interrupt()
+        }
+    }
+    
+    /// Counts `item` as running, unless it would run on a background lane while a cancellation
+    /// interrupt is in effect, in which case it must wait and `false` is returned.
+    private func reserve(_ item: Item) -> Bool {
+        let isBackground = item.classification.lane == .inspection || item.classification.lane == .evaluation
+        return runningWork.withLock { work -> Bool in
+            if isBackground && work.isCancellationInterruptActive {
+                return false
+            }
+            work.count += 1
+            return true
+        }
+    }
+    
+    /// Handles `item`, which must have been reserved.
+    private func perform(_ item: Item, in context: LaneContext) {
+        context.request = item.request
+        item.work(item.request)
+        context.request = nil
+        
+        let interrupts = runningWork.withLock { work -> [() -> Void] in
+            work.count -= 1
+            if work.count == 0 {
+                // The requests the deferred interrupts target have all finished.
+                work.isCancellationInterruptActive = false
+                work.deferredInterrupts.removeAll()
+            }
+            guard work.count == 1, !work.deferredInterrupts.isEmpty else {
+                return []
+            }
+            defer {
+                work.deferredInterrupts.removeAll()
+            }
+            work.isCancellationInterruptActive = true
+            return work.deferredInterrupts
+        }
+        for interrupt in interrupts {
+            interrupt()
+        }
+    }
+    
+    private func start(_ item: Item) {
+        let queue: DispatchQueue
+        let context: LaneContext
+        switch item.classification.lane {
+        case .control, .breakpoints:
+            // Requests on the main queue finish before any other request is scheduled.
+            perform(item, in: mainContext)
+            return
+        case .inspection:
+            queue = inspectionQueue
+            context = inspectionContext
+        case .evaluation:
+            queue = evaluationQueue
+            context = evaluationContext
+        }
+        
+        inFlightCount += 1
+        if item.classification.isExclusive {
+            isBarrierInFlight = true
+        }
+        
+        queue.async { [self] in
+            perform(item, in: context)
+            
+            DispatchQueue.main.async { [self] in
+                inFlightCount -= 1
+                if item.classification.isExclusive {
+                    isBarrierInFlight = false
+                }
+                startPendingItems()
+            }
+        }
+    }
+    
+    private func startPendingItems() {
+        if inFlightCount == 0 && isInterrupting {
+            isInterrupting = false
+            cancelInterruptHandler?()
+        }
+        
+        while let item = pendingItems.first {
+            if isBarrierInFlight || (item.classification.isExclusive && inFlightCount > 0) || !reserve(item) {
+                return
+            }
+            pendingItems.removeFirst()
+            start(item)
+        }
+    }
+}
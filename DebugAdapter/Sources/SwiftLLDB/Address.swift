@@ -47,6 +47,11 @@ public struct Address: Sendable {
         var lldbAddress = lldbAddress
         return Symbol(lldbAddress.GetSymbol())
     }
+    
+    public var module: Module? {
+        var lldbAddress = lldbAddress
+        return Module(lldbAddress.GetModule())
+    }
 }
 
 extension Address: Equatable {
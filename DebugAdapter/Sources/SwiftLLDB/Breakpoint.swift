@@ -91,6 +91,39 @@ extension Breakpoint {
     }
 }
 
+extension Breakpoint {
+    /// A handler run on LLDB's private state thread each time a location of a breakpoint is hit and
+    /// its ignore count and condition have passed. The process is stopped while the handler runs, and
+    /// it returns whether the process should stay stopped.
+    public final class Callback: @unchecked Sendable {
+        let handler: (Process, Thread, Location) -> Bool
+        
+        public init(_ handler: @escaping (Process, Thread, Location) -> Bool) {
+            self.handler = handler
+        }
+    }
+    
+    /// Sets or removes the breakpoint's callback.
+    ///
+    /// The breakpoint does not retain `callback`, which must be kept alive for as long as the
+    /// breakpoint can be hit, including while a hit that began before it was replaced is handled.
+    public func setCallback(_ callback: Callback?) {
+        var lldbBreakpoint = lldbBreakpoint
+        guard let callback else {
+            lldbBreakpoint.SetCallback(nil, nil)
+            return
+        }
+        
+        lldbBreakpoint.SetCallback({ baton, lldbProcess, lldbThread, lldbLocation in
+            guard let baton else {
+                return true
+            }
+            let callback = Unmanaged<Callback>.fromOpaque(baton).takeUnretainedValue()
+            return callback.handler(Process(unsafe: lldbProcess), Thread(unsafe: lldbThread), Location(unsafe: lldbLocation))
+        }, Unmanaged.passUnretained(callback).toOpaque())
+    }
+}
+
 extension Breakpoint {
     public func addName(_ name: String) throws {
         var lldbBreakpoint = lldbBreakpoint
@@ -0,0 +1,40 @@
+import CxxLLDB
+
+public struct CompileUnit: Sendable {
+    nonisolated(unsafe) let lldbCompileUnit: lldb.SBCompileUnit
+    
+    init?(_ lldbCompileUnit: lldb.SBCompileUnit) {
+        guard lldbCompileUnit.IsValid() else {
+            return nil
+        }
+        self.lldbCompileUnit = lldbCompileUnit
+    }
+    
+    init(unsafe lldbCompileUnit: lldb.SBCompileUnit) {
+        self.lldbCompileUnit = lldbCompileUnit
+    }
+    
+    public var fileSpec: FileSpec? {
+        return FileSpec(lldbCompileUnit.GetFileSpec())
+    }
+    
+    public var lineEntryCount: Int {
+        return Int(lldbCompileUnit.GetNumLineEntries())
+    }
+    
+    public func lineEntry(at index: Int) -> LineEntry? {
+        return LineEntry(lldbCompileUnit.GetLineEntryAtIndex(UInt32(index)))
+    }
+    
+    /// Whether the file is the compile unit's primary file or one of the support files its line table refers to.
+    func refersTo(_ lldbFileSpec: lldb.SBFileSpec) -> Bool {
+        var lldbCompileUnit = lldbCompileUnit
+        return lldbCompileUnit.FindSupportFileIndex(0, lldbFileSpec, true) != UInt32.max
+    }
+}
+
+extension CompileUnit: Equatable {
+    public static func == (lhs: CompileUnit, rhs: CompileUnit) -> Bool {
+        return lhs.lldbCompileUnit == rhs.lldbCompileUnit
+    }
+}
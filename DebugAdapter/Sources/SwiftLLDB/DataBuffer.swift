@@ -48,6 +48,18 @@ extension DataBuffer: RandomAccessCollection {
     }
 }
 
+extension DataBuffer {
+    /// Copies the contents of the buffer, which is much faster than reading it one byte at a time.
+    public var bytes: [UInt8] {
+        var lldbData = lldbData
+        let count = lldbData.GetByteSize()
+        return [UInt8](unsafeUninitializedCapacity: count) { buffer, initializedCount in
+            var error = lldb.SBError()
+            initializedCount = count > 0 ? lldbData.ReadRawData(&error, 0, buffer.baseAddress, count) : 0
+        }
+    }
+}
+
 extension DataBuffer {
     public func read(atByteOffset byteOffset: Int = 0, as type: Float.Type) throws -> Float {
         var lldbData = lldbData
@@ -18,4 +18,55 @@ public struct DataType: Sendable {
         var lldbType = lldbType
         return lldbType.GetByteSize()
     }
-}
\ No newline at end of file
+    
+    public var isPointer: Bool {
+        return hasFlag(lldb.eTypeIsPointer)
+    }
+    
+    public var isArray: Bool {
+        return hasFlag(lldb.eTypeIsArray)
+    }
+    
+    public var isVector: Bool {
+        return hasFlag(lldb.eTypeIsVector)
+    }
+    
+    /// Whether the type is a struct, union or class, whose children are its named members.
+    public var isAggregate: Bool {
+        return hasFlag(lldb.eTypeIsStructUnion) || hasFlag(lldb.eTypeIsClass)
+    }
+    
+    public var isSigned: Bool {
+        return hasFlag(lldb.eTypeIsSigned)
+    }
+    
+    /// Whether the integers of the type, or of an enumeration's underlying type, are signed, or `nil`
+    /// if the type is not an integer of at most 64 bits.
+    public var isSignedInteger: Bool? {
+        var lldbType = lldbType
+        var lldbCanonicalType = lldbType.GetCanonicalType()
+        if lldbCanonicalType.GetTypeFlags() & lldb.eTypeIsEnumeration.rawValue != 0 {
+            return DataType(lldbCanonicalType.GetEnumerationIntegerType())?.isSignedInteger
+        }
+        
+        switch lldbCanonicalType.GetBasicType() {
+        case lldb.eBasicTypeSignedChar, lldb.eBasicTypeSignedWChar, lldb.eBasicTypeShort, lldb.eBasicTypeInt, lldb.eBasicTypeLong, lldb.eBasicTypeLongLong:
+            return true
+        case lldb.eBasicTypeUnsignedChar, lldb.eBasicTypeUnsignedWChar, lldb.eBasicTypeUnsignedShort, lldb.eBasicTypeUnsignedInt, lldb.eBasicTypeUnsignedLong, lldb.eBasicTypeUnsignedLongLong,
+             lldb.eBasicTypeChar8, lldb.eBasicTypeChar16, lldb.eBasicTypeChar32, lldb.eBasicTypeBool:
+            return false
+        case lldb.eBasicTypeChar, lldb.eBasicTypeWChar:
+            // Plain characters are signed or not depending on the platform.
+            return isSigned
+        default:
+            return nil
+        }
+    }
+    
+    /// Checks the flags of the canonical type, so that typedefs report the kind of type they name.
+    private func hasFlag(_ flag: lldb.TypeFlags) -> Bool {
+        var lldbType = lldbType
+        var lldbCanonicalType = lldbType.GetCanonicalType()
+        return lldbCanonicalType.GetTypeFlags() & flag.rawValue != 0
+    }
+}
@@ -145,44 +145,6 @@ extension Debugger {
 }
 
 extension Debugger {
-    public struct Events: AsyncSequence {
-        fileprivate let debugger: Debugger
-        
-        fileprivate init(_ debugger: Debugger) {
-            self.debugger = debugger
-        }
-        
-        public struct AsyncIterator: AsyncIteratorProtocol {
-            fileprivate let debugger: Debugger
-            
-            fileprivate var listener: lldb.SBListener
-            
-            init(_ debugger: Debugger) {
-                self.debugger = debugger
-                var lldbDebugger = debugger.lldbDebugger
-                self.listener = lldbDebugger.GetListener()
-            }
-            
-            public mutating func next() async -> Event? {
-                while !Task.isCancelled {
-                    var lldbEvent = lldb.SBEvent()
-                    if listener.WaitForEvent(1, &lldbEvent),
-                       let event = Event(lldbEvent) {
-                        return event
-                    }
-                    await Task.yield()
-                }
-                return nil
-            }
-        }
-        
-        public func makeAsyncIterator() -> AsyncIterator {
-            return AsyncIterator(debugger)
-        }
-    }
-    
-    public var events: Events { Events(self) }
-    
     public func startListening(to target: Target, events: TargetEvent.EventType) {
         var lldbDebugger = lldbDebugger
         var listener = lldbDebugger.GetListener()
@@ -192,9 +154,116 @@ extension Debugger {
     }
 }
 
+extension Debugger {
+    /// Delivers LLDB's reports of long-running work, such as indexing debug info, to the debugger's listener.
+    public func startListeningForProgress() {
+        var lldbDebugger = lldbDebugger
+        var listener = lldbDebugger.GetListener()
+        
+        let debuggerBroadcaster = lldbDebugger.GetBroadcaster()
+        listener.StartListeningForEvents(debuggerBroadcaster, lldb.eBroadcastBitProgress.rawValue)
+    }
+}
+
+extension Debugger {
+    /// Asks long-running operations on any thread to stop early. Remains in effect until `cancelInterruptRequest()`.
+    public func requestInterrupt() {
+        var lldbDebugger = lldbDebugger
+        lldbDebugger.RequestInterrupt()
+    }
+    
+    public func cancelInterruptRequest() {
+        var lldbDebugger = lldbDebugger
+        lldbDebugger.CancelInterruptRequest()
+    }
+}
+
+extension Debugger {
+    /// Whether process control calls such as `launch` and `resume` return immediately, rather than once the process stops.
+    public var isAsynchronous: Bool {
+        get {
+            var lldbDebugger = lldbDebugger
+            return lldbDebugger.GetAsync()
+        }
+        set {
+            var lldbDebugger = lldbDebugger
+            lldbDebugger.SetAsync(newValue)
+        }
+    }
+}
+
+extension Debugger {
+    /// Sets one of the debugger's settings, as `settings set` would.
+    public func setSetting(_ name: String, value: String) throws {
+        var lldbDebugger = lldbDebugger
+        let error = lldb.SBDebugger.SetInternalVariable(name, value, lldbDebugger.GetInstanceName())
+        try error.throwOnFail()
+    }
+}
+
 extension Debugger {
     public var commandInterpreter: CommandInterpreter {
         var lldbDebugger = lldbDebugger
         return CommandInterpreter(lldbDebugger.GetCommandInterpreter())
     }
 }
+
+public struct ProgressEvent: Sendable {
+    nonisolated(unsafe) let lldbEvent: lldb.SBEvent
+    
+    /// Identifies the work being reported on across its start, updates and end.
+    public let id: UInt64
+    public let message: String
+    public let completed: UInt64
+    
+    /// The amount of work to complete, or `nil` if it is not known in advance.
+    public let total: UInt64?
+    
+    /// Whether this is the last report for the work.
+    public let isFinished: Bool
+    
+    /// Whether the work concerns only this debugger, rather than modules shared by all debuggers.
+    public let isDebuggerSpecific: Bool
+    
+    init(_ lldbEvent: lldb.SBEvent) {
+        self.lldbEvent = lldbEvent
+        
+        var id: UInt64 = 0
+        var completed: UInt64 = 0
+        var total: UInt64 = 0
+        var isDebuggerSpecific = false
+        let message = lldb.SBDebugger.GetProgressFromEvent(lldbEvent, &id, &completed, &total, &isDebuggerSpecific)
+        
+        self.id = id
+        self.message = String(optionalCString: message) ?? ""
+        self.completed = completed
+        self.total = total == UInt64.max ? nil : total
+        self.isFinished = completed == total
+        self.isDebuggerSpecific = isDebuggerSpecific
+    }
+    
+    static func isProgressEvent(_ lldbEvent: lldb.SBEvent) -> Bool {
+        guard let broadcasterClass = String(optionalCString: lldbEvent.GetBroadcasterClass()),
+              broadcasterClass == String(optionalCString: lldb.SBDebugger.GetBroadcasterClass()) else {
+            return false
+        }
+        return lldbEvent.GetType() & lldb.eBroadcastBitProgress.rawValue != 0
+    }
+    
+    private var data: StructuredData? {
+        return StructuredData(lldb.SBDebugger.GetProgressDataFromEvent(lldbEvent))
+    }
+    
+    /// The kind of work, such as “Manually indexing DWARF”, without the details of this instance of it.
+    public var title: String {
+        return data?["title"]?.asString() ?? message
+    }
+    
+    /// What the work concerns, such as the module being indexed.
+    public var details: String? {
+        guard let details = data?["details"]?.asString(), !details.isEmpty else {
+            return nil
+        }
+        return details
+    }
+}
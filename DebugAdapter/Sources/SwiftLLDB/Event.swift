@@ -3,6 +3,7 @@ import CxxLLDB
 public enum Event: Sendable {
     case breakpoint(BreakpointEvent)
     case process(ProcessEvent)
+    case progress(ProgressEvent)
     case target(TargetEvent)
     case thread(ThreadEvent)
 }
@@ -21,6 +22,9 @@ extension Event {
         else if lldb.SBThread.EventIsThreadEvent(lldbEvent) {
             self = .thread(ThreadEvent(lldbEvent))
         }
+        else if ProgressEvent.isProgressEvent(lldbEvent) {
+            self = .progress(ProgressEvent(lldbEvent))
+        }
         else {
             return nil
         }
@@ -0,0 +1,111 @@
+import CxxLLDB
+import Dispatch
+import Foundation
+
+/// Delivers a debugger's events in the order LLDB broadcast them, from a dedicated listener thread.
+///
+/// The thread blocks in `SBListener::WaitForEvent` with no timeout and is woken through a private
+/// broadcaster when the pump is stopped. At most `capacity` events wait for the handler at a time;
+/// while the handler is behind, the thread stops taking events and leaves them queued in LLDB.
+public final class EventPump: @unchecked Sendable {
+    nonisolated(unsafe) private let lldbListener: lldb.SBListener
+    nonisolated(unsafe) private let lldbWakeBroadcaster: lldb.SBBroadcaster
+    
+    private static let wakeEventType: UInt32 = 1 << 0
+    
+    private let queue: DispatchQueue
+    private let handler: (Event, ContinuousClock.Instant) -> Void
+    private let capacity: DispatchSemaphore
+    
+    private let lock = NSLock()
+    private var isStarted = false
+    private var _isStopped = false
+    
+    /// Creates a pump which invokes `handler` on `queue`, which must be serial, with each event and the time it was received from LLDB.
+    public init(debugger: Debugger, capacity: Int = 64, queue: DispatchQueue, handler: @escaping (Event, ContinuousClock.Instant) -> Void) {
+        var lldbDebugger = debugger.lldbDebugger
+        var lldbListener = lldbDebugger.GetListener()
+        let lldbWakeBroadcaster = lldb.SBBroadcaster("com.panic.debugadapter.event-pump")
+        lldbListener.StartListeningForEvents(lldbWakeBroadcaster, Self.wakeEventType)
+        
+        self.lldbListener = lldbListener
+        self.lldbWakeBroadcaster = lldbWakeBroadcaster
+        self.queue = queue
+        self.handler = handler
+        self.capacity = DispatchSemaphore(value: max(1, capacity))
+    }
+    
+    private var isStopped: Bool {
+        lock.lock()
+        defer { lock.unlock() }
+        return _isStopped
+    }
+    
+    public func start() {
+        lock.lock()
+        defer { lock.unlock() }
+        guard !isStarted && !_isStopped else {
+            return
+        }
+        isStarted = true
+        
+        let thread = Foundation.Thread { [self] in
+            run()
+        }
+        thread.name = "com.panic.debugadapter.event-pump"
+        thread.qualityOfService = .userInitiated
+        thread.start()
+    }
+    
+    /// Wakes the listener thread and makes it exit. Events not yet handled are discarded.
+    public func stop() {
+        lock.lock()
+        guard !_isStopped else {
+            lock.unlock()
+            return
+        }
+        _isStopped = true
+        lock.unlock()
+        
+        var lldbWakeBroadcaster = lldbWakeBroadcaster
+        lldbWakeBroadcaster.BroadcastEventByType(Self.wakeEventType, false)
+        
+        // Release the thread if it is waiting for room in the channel.
+        capacity.signal()
+    }
+    
+    private func run() {
+        var lldbListener = lldbListener
+        
+        while !isStopped {
+            var lldbEvent = lldb.SBEvent()
+            // A timeout of UINT32_MAX waits indefinitely.
+            guard lldbListener.WaitForEvent(UInt32.max, &lldbEvent) else {
+                continue
+            }
+            let receivedAt = ContinuousClock.now
+            
+            if lldbEvent.BroadcasterMatchesRef(lldbWakeBroadcaster) {
+                continue
+            }
+            guard let event = Event(lldbEvent) else {
+                continue
+            }
+            
+            capacity.wait()
+            guard !isStopped else {
+                return
+            }
+            
+            queue.async { [self] in
+                defer {
+                    capacity.signal()
+                }
+                guard !isStopped else {
+                    return
+                }
+                handler(event, receivedAt)
+            }
+        }
+    }
+}
@@ -10,6 +10,11 @@ public struct FileSpec: Sendable {
         self.lldbFileSpec = lldbFileSpec
     }
     
+    /// A file spec for `path`, with relative components such as `..` resolved.
+    public init?(path: String) {
+        self.init(lldb.SBFileSpec(path, true))
+    }
+    
     public var directory: String {
         return String(cString: lldbFileSpec.GetDirectory())
     }
@@ -128,4 +128,11 @@ extension Frame {
         let lldbValue = lldbFrame.FindVariable(name)
         return Value(lldbValue)
     }
+    
+    /// Finds a value by a path such as `req->id` or `items[2].name`, without running the expression parser.
+    public func findValue(forVariablePath path: String) -> Value? {
+        var lldbFrame = lldbFrame
+        let lldbValue = lldbFrame.GetValueForVariablePath(path)
+        return Value(lldbValue)
+    }
 }
\ No newline at end of file
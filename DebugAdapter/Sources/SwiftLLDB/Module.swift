@@ -0,0 +1,76 @@
+import CxxLLDB
+
+public struct Module: Sendable {
+    nonisolated(unsafe) let lldbModule: lldb.SBModule
+    
+    init?(_ lldbModule: lldb.SBModule) {
+        guard lldbModule.IsValid() else {
+            return nil
+        }
+        self.lldbModule = lldbModule
+    }
+    
+    init(unsafe lldbModule: lldb.SBModule) {
+        self.lldbModule = lldbModule
+    }
+    
+    public var fileSpec: FileSpec? {
+        return FileSpec(lldbModule.GetFileSpec())
+    }
+    
+    /// The module's UUID, which changes whenever the binary is rebuilt.
+    public var uuid: String? {
+        return String(optionalCString: lldbModule.GetUUIDString())
+    }
+    
+    /// The file that symbols were loaded from, which is the module itself unless there is a separate debug symbol file.
+    ///
+    /// This locates the symbol file if it has not been located yet, which may involve a search for dSYMs.
+    public var symbolFileSpec: FileSpec? {
+        return FileSpec(lldbModule.GetSymbolFileSpec())
+    }
+    
+    public var objectFileHeaderAddress: Address? {
+        return Address(lldbModule.GetObjectFileHeaderAddress())
+    }
+    
+    /// Where the module's header is loaded in `target`, or `nil` if the module is not loaded.
+    public func headerLoadAddress(in target: Target) -> UInt64? {
+        guard let address = objectFileHeaderAddress?.loadAddress(for: target), address != LLDB_INVALID_ADDRESS else {
+            return nil
+        }
+        return address
+    }
+    
+    /// The module's version components, or an empty array if it has no version.
+    public var version: [Int] {
+        var lldbModule = lldbModule
+        var versions = [UInt32](repeating: 0, count: 3)
+        let count = Int(lldbModule.GetVersion(&versions, UInt32(versions.count)))
+        return versions.prefix(min(count, versions.count)).map { Int($0) }
+    }
+    
+    /// The symbols in the module's symbol table, in no particular order.
+    public var symbols: [Symbol] {
+        var lldbModule = lldbModule
+        return (0 ..< lldbModule.GetNumSymbols()).compactMap { Symbol(lldbModule.GetSymbolAtIndex($0)) }
+    }
+    
+    public var compileUnits: [CompileUnit] {
+        var lldbModule = lldbModule
+        return (0 ..< lldbModule.GetNumCompileUnits()).compactMap { CompileUnit(lldbModule.GetCompileUnitAtIndex($0)) }
+    }
+    
+    /// Parses the module's symbol table and compile units now, rather than when they are first needed.
+    public func preloadSymbols() {
+        var lldbModule = lldbModule
+        _ = lldbModule.GetNumSymbols()
+        _ = lldbModule.GetNumCompileUnits()
+    }
+}
+
+extension Module: Equatable {
+    public static func == (lhs: Module, rhs: Module) -> Bool {
+        return lhs.lldbModule == rhs.lldbModule
+    }
+}
@@ -209,6 +209,27 @@ extension Process {
         return MemoryRegionInfo(region)
     }
     
+    /// The regions of the address space in ascending order, or none if the platform cannot list them.
+    public var memoryRegions: [MemoryRegionInfo] {
+        var lldbProcess = lldbProcess
+        var lldbRegions = lldbProcess.GetMemoryRegions()
+        
+        var regions: [MemoryRegionInfo] = []
+        for index in 0 ..< lldbRegions.GetSize() {
+            var region = lldb.SBMemoryRegionInfo()
+            if lldbRegions.GetMemoryRegionAtIndex(index, &region) {
+                regions.append(MemoryRegionInfo(region))
+            }
+        }
+        return regions
+    }
+    
+    /// Incremented each time the process stops, including, if requested, when an expression finishes running code in it.
+    public func stopID(includingExpressionStops: Bool) -> UInt32 {
+        var lldbProcess = lldbProcess
+        return lldbProcess.GetStopID(includingExpressionStops)
+    }
+    
     public func readMemory(_ buffer: UnsafeMutableBufferPointer<UInt8>, at address: UInt64) throws -> Int {
         var lldbProcess = lldbProcess
         var error = lldb.SBError()
@@ -240,6 +261,33 @@ extension Process {
         try error.throwOnFail()
         return bytesWritten
     }
+    
+    /// The addresses where `pattern` starts within `ranges`, in order, at most `maximumMatchCount` of them.
+    /// Only addresses that are a multiple of `alignment` are matched.
+    public func findInMemory(_ pattern: [UInt8], in ranges: [Range<UInt64>], alignment: Int = 1, maximumMatchCount: Int) throws -> [UInt64] {
+        var lldbProcess = lldbProcess
+        var lldbTarget = lldbProcess.GetTarget()
+        
+        var lldbRanges = lldb.SBAddressRangeList()
+        for range in ranges {
+            let lldbAddress = lldb.SBAddress(range.lowerBound, &lldbTarget)
+            lldbRanges.Append(lldb.SBAddressRange(lldbAddress, range.upperBound - range.lowerBound))
+        }
+        
+        var error = lldb.SBError()
+        var lldbMatches = pattern.withUnsafeBytes { bytes in
+            lldbProcess.FindRangesInMemory(bytes.baseAddress, UInt64(bytes.count), lldbRanges, UInt32(alignment), UInt32(maximumMatchCount), &error)
+        }
+        try error.throwOnFail()
+        
+        var matches: [UInt64] = []
+        for index in 0 ..< lldbMatches.GetSize() {
+            var lldbMatch = lldbMatches.GetAddressRangeAtIndex(UInt64(index))
+            var lldbAddress = lldbMatch.GetBaseAddress()
+            matches.append(lldbAddress.GetLoadAddress(lldbTarget))
+        }
+        return matches
+    }
 }
 
 extension Process.Info {
@@ -48,6 +48,16 @@ extension StructuredData {
     }
 }
 
+extension StructuredData {
+    public var jsonString: String? {
+        var stream = lldb.SBStream()
+        guard lldbStructuredData.GetAsJSON(&stream).Success() else {
+            return nil
+        }
+        return String(optionalCString: stream.GetData())
+    }
+}
+
 extension StructuredData {
     public subscript(_ key: String) -> StructuredData? {
         return StructuredData(lldbStructuredData.GetValueForKey(key))
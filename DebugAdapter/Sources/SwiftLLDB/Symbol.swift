@@ -36,8 +36,20 @@ public struct Symbol: Sendable {
         return Address(lldbSymbol.GetEndAddress())
     }
     
+    /// Whether the symbol is a function or other code, rather than data or a debugging symbol.
+    public var isCode: Bool {
+        var lldbSymbol = lldbSymbol
+        return lldbSymbol.GetType() == lldb.eSymbolTypeCode
+    }
+    
     public var size: UInt64 {
         var lldbSymbol = lldbSymbol
         return lldbSymbol.GetSize()
     }
+    
+    /// Disassembles the whole symbol, reading the target's memory if it has a process.
+    public func instructions(in target: Target) -> InstructionList? {
+        var lldbSymbol = lldbSymbol
+        return InstructionList(lldbSymbol.GetInstructions(target.lldbTarget))
+    }
 }
\ No newline at end of file
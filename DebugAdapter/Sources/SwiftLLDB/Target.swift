@@ -41,6 +41,11 @@ extension Target {
         var lldbTarget = lldbTarget
         return Platform(lldbTarget.GetPlatform())
     }
+    
+    public var modules: [Module] {
+        var lldbTarget = lldbTarget
+        return (0 ..< lldbTarget.GetNumModules()).compactMap { Module(lldbTarget.GetModuleAtIndex($0)) }
+    }
 }
 
 extension Target {
@@ -129,6 +134,25 @@ extension Target {
     }
 }
 
+extension Target {
+    /// Loads a core file as a stopped process whose memory is read from the file as it is needed.
+    public func loadCore(path: String) throws -> Process {
+        var lldbTarget = lldbTarget
+        var error = lldb.SBError()
+        let lldbProcess = lldbTarget.LoadCore(path, &error)
+        try error.throwOnFail()
+        return Process(unsafe: lldbProcess)
+    }
+    
+    /// Finds the modules that a process loaded from paths starting with `from` under `to` instead.
+    public func appendImageSearchPath(from: String, to: String) throws {
+        var lldbTarget = lldbTarget
+        var error = lldb.SBError()
+        lldbTarget.AppendImageSearchPath(from, to, &error)
+        try error.throwOnFail()
+    }
+}
+
 extension Target {
     public func createBreakpoint(path: String, line: Int) -> Breakpoint {
         var lldbTarget = lldbTarget
@@ -208,6 +232,24 @@ extension Target {
     }
 }
 
+extension Target {
+    /// The compile units whose line tables refer to the source file at `path`, with the modules that
+    /// contain them.
+    ///
+    /// Unlike `SBTarget::FindCompileUnits`, which matches only a compile unit's primary file, this
+    /// includes compile units that use the file as a header or inline code from it.
+    public func findCompileUnits(path: String) -> [(module: Module, compileUnit: CompileUnit)] {
+        let lldbFileSpec = lldb.SBFileSpec(path)
+        var result: [(module: Module, compileUnit: CompileUnit)] = []
+        for module in modules {
+            for compileUnit in module.compileUnits where compileUnit.refersTo(lldbFileSpec) {
+                result.append((module, compileUnit))
+            }
+        }
+        return result
+    }
+}
+
 extension Target {
     public func readInstructions(at address: Address, count: Int) -> InstructionList? {
         var lldbTarget = lldbTarget
@@ -216,6 +258,18 @@ extension Target {
     }
 }
 
+extension Target {
+    /// LLDB's statistics for the target, such as the time spent loading and indexing symbols and evaluating expressions.
+    ///
+    /// Unless `summaryOnly` is set, the statistics include details of each module.
+    public func statistics(summaryOnly: Bool = false) -> StructuredData? {
+        var lldbTarget = lldbTarget
+        var options = lldb.SBStatisticsOptions()
+        options.SetSummaryOnly(summaryOnly)
+        return StructuredData(lldbTarget.GetStatistics(options))
+    }
+}
+
 extension Target {
     public func evaluate(expression: String) throws -> Value {
         var lldbTarget = lldbTarget
@@ -253,4 +307,10 @@ public struct TargetEvent: Sendable {
     public var target: Target {
         return Target(unsafe: lldb.SBTarget.GetTargetFromEvent(lldbEvent))
     }
+    
+    /// The modules loaded, unloaded or given symbols, for module events.
+    public var modules: [Module] {
+        let count = lldb.SBTarget.GetNumModulesFromEvent(lldbEvent)
+        return (0 ..< count).compactMap { Module(lldb.SBTarget.GetModuleAtIndexFromEvent($0, lldbEvent)) }
+    }
 }
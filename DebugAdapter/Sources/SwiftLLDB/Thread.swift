@@ -237,6 +237,14 @@ extension Thread {
         try error.throwOnFail()
     }
     
+    /// Moves the thread's program counter to the code for `line` in the current function.
+    public func jump(to fileSpec: FileSpec, line: Int) throws {
+        var lldbThread = lldbThread
+        var lldbFileSpec = fileSpec.lldbFileSpec
+        let error = lldbThread.JumpToLine(&lldbFileSpec, UInt32(line))
+        try error.throwOnFail()
+    }
+    
     public func stepOver() throws {
         var lldbThread = lldbThread
         var error = lldb.SBError()
@@ -295,6 +303,16 @@ extension Thread {
     
     public var frames: Frames { Frames(lldbThread) }
     
+    /// The frame at `index`, or `nil` if the stack is not that deep.
+    /// Unlike `frames.count`, this only unwinds the stack as far as `index`.
+    public func frame(at index: Int) -> Frame? {
+        guard let index = UInt32(exactly: index) else {
+            return nil
+        }
+        var lldbThread = lldbThread
+        return Frame(lldbThread.GetFrameAtIndex(index))
+    }
+    
     public var selectedFrame: Frame? {
         var lldbThread = lldbThread
         let lldbFrame = lldbThread.GetSelectedFrame()
@@ -203,6 +203,18 @@ extension Value {
     
     public var children: Children { Children(lldbValue) }
     
+    /// The number of children, counting no further than `max`.
+    /// Unlike `children.count`, this does not require a synthetic child provider to realize every child.
+    public func childCount(max: Int) -> Int {
+        var lldbValue = lldbValue
+        return Int(lldbValue.GetNumChildren(UInt32(clamping: max)))
+    }
+    
+    public func child(at index: Int) -> Value? {
+        var lldbValue = lldbValue
+        return Value(lldbValue.GetChildAtIndex(UInt32(index)))
+    }
+    
     public func childMember(named name: String) -> Value? {
         var lldbValue = lldbValue
         return Value(lldbValue.GetChildMemberWithName(name))
@@ -223,6 +235,12 @@ extension Value {
         return DataBuffer(data)
     }
     
+    /// The frame the value was found in, if it belongs to one.
+    public var frame: Frame? {
+        var lldbValue = lldbValue
+        return Frame(lldbValue.GetFrame())
+    }
+    
     public var declaration: Declaration? {
         var lldbValue = lldbValue
         return Declaration(lldbValue.GetDeclaration())